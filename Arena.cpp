@@ -1,300 +1,383 @@
 #include <iostream>
-#include <dlfcn.h>
 #include <vector>
-#include <iomanip>
-#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <cstdint>
+#include <random>
+#include <memory>
 #include "RobotBase.h"
-#include "RadarObj.h"
+#include "RobotLoader.h"
+#include "Match.h"
+#include "OccupancyGrid.h"
+#include "ThreadPool.h"
+#include "Tournament.h"
+#include "Rollout.h"
+#include "Profiler.h"
+#include "EventLog.h"
+#include "Sandbox.h"
 
 //
 // =========================================================
-//  ARENA CONSTANTS
+//  COMMAND LINE
 // =========================================================
 //
 
-static const int BOARD_ROWS = 20;
-static const int BOARD_COLS = 20;
-
-//
-// =========================================================
-//  WEAPON DAMAGE TABLE  (Professor style)
-// =========================================================
-//
-
-int get_weapon_damage(WeaponType w)
+struct ArenaOptions
 {
-    switch (w)
-    {
-        case flamethrower: return 5;
-        case railgun:      return 12;
-        case grenade:      return 20;
-        case hammer:       return 8;
-        default:           return 0;
-    }
+    bool headless = false;
+    bool render = false;  // redraw the board in place, from a thread of its own, instead of scrolling text
+    double fps = 0;       // frame cap for --render, 0 = none; never slows the match
+    const char *record_path = nullptr;   // .rwz replay of a single match
+    int matches = 1;
+    int threads = 0;     // 0 = one per hardware thread
+    bool tournament = false;
+    int seeds = 2;       // tournament games per pairing
+    int rollouts = 0;    // > 0: play the match on this many times from from_round
+    int from_round = 0;
+    uint64_t seed = std::random_device{}();   // match i uses seed + i
+    int robots = 0;      // 0 = one per robot given; more cycles through them
+    MatchOptions match;  // board, obstacles and round limits; every match starts from a copy
+    bool profile = false;                 // time every call into the robots
+    const char *profile_csv = nullptr;    // and write the timings here
+    const char *events_path = nullptr;    // structured match events go here
+    EventFormat events_format = EVENTS_JSONL;
+    bool events_wait = false;             // matches wait for the writer rather than drop events
+    std::vector<const char *> robot_paths;
+};
+
+void print_usage()
+{
+    std::cout << "Usage: ./RobotWarz [--headless | --render [--fps F]] [--pace R] [--seed S] [--record FILE] [--robots N] robot1.so robot2.so ...\n"
+              << "       ./RobotWarz [--matches N] [--threads T] [--seed S] [--robots N] robot1.so robot2.so ...\n"
+              << "       ./RobotWarz --tournament [--seeds K] [--threads T] [--seed S] [robot_dir]\n"
+              << "       ./RobotWarz --rollouts N [--from-round R] [--threads T] [--seed S] [--robots N] robot1.so robot2.so ...\n"
+              << "any mode also takes [--board RxC] [--obstacles N]  (default 20x20, one obstacle per 80 cells)\n"
+              << "                    [--max-rounds N] [--stalemate R] (default " << MAX_ROUNDS << " and "
+              << STALEMATE_REPEATS << " repeats, 0 = off)\n"
+              << "                    [--sandbox]  (run each robot in a process of its own)\n"
+              << "                    [--turn-budget MS] [--overruns N]  (per robot call, default off; "
+              << MAX_OVERRUNS << " overruns disqualify)\n"
+              << "                    [--profile] [--profile-csv FILE]  (robot call latency per robot)\n"
+              << "                    [--events FILE] [--events-format jsonl|binary]  (every round, shot, hit, move\n"
+              << "                    and death, written by a background thread)\n"
+              << "                    [--events-wait]  (matches wait for a slow event writer instead of dropping events)\n";
 }
 
-//
-// =========================================================
-//  SIMPLE SHOT CHECK
-// =========================================================
-//
-
-bool shot_hits_robot(int shot_r, int shot_c, int robot_r, int robot_c)
+// "RxC", e.g. "64x64"
+bool parse_board(const char *arg, MatchOptions &board)
 {
-    return (shot_r == robot_r && shot_c == robot_c);
+    char extra = 0;
+    return std::sscanf(arg, "%dx%d%c", &board.rows, &board.cols, &extra) == 2;
 }
 
-//
-// =========================================================
-//  RADAR SCAN FUNCTION (8-direction line scan)
-// =========================================================
-//
-
-std::vector<RadarObj> perform_radar_scan(int start_r, int start_c, int direction,
-                                         const std::vector<RadarObj> &obstacles,
-                                         int enemy_r, int enemy_c)
+// returns false if the arguments don't make sense
+bool parse_options(int argc, char **argv, ArenaOptions &opts)
 {
-    std::vector<RadarObj> results;
-
-    // movement vectors for 8 directions
-    int dr[8] = {-1,-1,0,1,1,1,0,-1};
-    int dc[8] = { 0, 1,1,1,0,-1,-1,-1};
-
-    int r = start_r;
-    int c = start_c;
-
-    while (true)
+    for (int i = 1; i < argc; i++)
     {
-        r += dr[direction];
-        c += dc[direction];
-
-        if (r < 0 || c < 0 || r >= BOARD_ROWS || c >= BOARD_COLS)
-            break;
-
-        // enemy seen
-        if (r == enemy_r && c == enemy_c)
+        if (std::strcmp(argv[i], "--headless") == 0)
+            opts.headless = true;
+        else if (std::strcmp(argv[i], "--render") == 0)
+            opts.render = true;
+        else if (std::strcmp(argv[i], "--fps") == 0 && i + 1 < argc)
+            opts.fps = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--pace") == 0 && i + 1 < argc)
+            opts.match.rounds_per_sec = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            opts.record_path = argv[++i];
+        else if (std::strcmp(argv[i], "--matches") == 0 && i + 1 < argc)
+            opts.matches = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            opts.threads = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--tournament") == 0)
+            opts.tournament = true;
+        else if (std::strcmp(argv[i], "--seeds") == 0 && i + 1 < argc)
+            opts.seeds = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--rollouts") == 0 && i + 1 < argc)
+            opts.rollouts = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--from-round") == 0 && i + 1 < argc)
+            opts.from_round = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            opts.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--robots") == 0 && i + 1 < argc)
+            opts.robots = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--board") == 0 && i + 1 < argc)
         {
-            results.push_back(RadarObj('R', r, c));
-            break;
+            if (!parse_board(argv[++i], opts.match))
+                return false;
         }
-
-        // obstacle check
-        for (auto &ob : obstacles)
+        else if (std::strcmp(argv[i], "--obstacles") == 0 && i + 1 < argc)
+            opts.match.obstacles = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--max-rounds") == 0 && i + 1 < argc)
+            opts.match.max_rounds = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--stalemate") == 0 && i + 1 < argc)
+            opts.match.stalemate_repeats = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--sandbox") == 0)
+            opts.match.sandbox = true;
+        else if (std::strcmp(argv[i], "--turn-budget") == 0 && i + 1 < argc)
+            opts.match.turn_budget_ms = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--overruns") == 0 && i + 1 < argc)
+            opts.match.max_overruns = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--profile") == 0)
+            opts.profile = true;
+        else if (std::strcmp(argv[i], "--profile-csv") == 0 && i + 1 < argc)
         {
-            if (ob.m_row == r && ob.m_col == c)
-            {
-                results.push_back(ob);
-                return results;
-            }
+            opts.profile = true;
+            opts.profile_csv = argv[++i];
         }
+        else if (std::strcmp(argv[i], "--events") == 0 && i + 1 < argc)
+            opts.events_path = argv[++i];
+        else if (std::strcmp(argv[i], "--events-wait") == 0)
+            opts.events_wait = true;
+        else if (std::strcmp(argv[i], "--events-format") == 0 && i + 1 < argc)
+        {
+            const char *format = argv[++i];
+            if (std::strcmp(format, "jsonl") == 0)
+                opts.events_format = EVENTS_JSONL;
+            else if (std::strcmp(format, "binary") == 0)
+                opts.events_format = EVENTS_BINARY;
+            else
+                return false;
+        }
+        else
+            opts.robot_paths.push_back(argv[i]);
     }
 
-    return results;
+    if (opts.matches < 1 || opts.threads < 0 || opts.seeds < 1 || opts.fps < 0)
+        return false;
+    if (opts.match.max_rounds < 1 || opts.match.stalemate_repeats < 0)
+        return false;
+    if (opts.match.turn_budget_ms < 0 || opts.match.max_overruns < 0)
+        return false;
+    if (opts.headless && opts.render)
+        return false;
+    if (opts.rollouts < 0 || opts.from_round < 0)
+        return false;
+
+    // --pace is for watching one match
+    if (opts.match.rounds_per_sec < 0)
+        return false;
+    if (opts.match.rounds_per_sec > 0 &&
+        (opts.matches > 1 || opts.threads > 0 || opts.tournament || opts.rollouts > 0))
+        return false;
+
+    const MatchOptions &board = opts.match;
+    if (board.rows < MIN_BOARD_SIZE || board.cols < MIN_BOARD_SIZE ||
+        board.rows > MAX_BOARD_SIZE || board.cols > MAX_BOARD_SIZE)
+        return false;
+
+    // obstacles may cover at most half the board, so there's always room
+    // to drop robots in
+    long long cells = static_cast<long long>(board.rows) * board.cols;
+    int obstacles = obstacle_count(board.rows, board.cols, board.obstacles);
+    if (board.obstacles < -1 || obstacles > cells / 2)
+        return false;
+
+    // tiled boards are too big to draw, and a replay stores at most
+    // 65535 obstacles
+    if (opts.render && is_sparse_board(board.rows, board.cols))
+        return false;
+    if (opts.record_path && obstacles > UINT16_MAX)
+        return false;
+
+    // rollouts copy the paused arena, which only dense in-process boards
+    // have, and every paused robot, which a watchdog may have given up on
+    if (opts.rollouts > 0 && (opts.tournament || opts.match.sandbox || opts.match.turn_budget_ms > 0 ||
+                              is_sparse_board(board.rows, board.cols)))
+        return false;
+
+    int paths = static_cast<int>(opts.robot_paths.size());
+
+    // a tournament takes an optional directory instead of robots
+    if (opts.tournament)
+        return paths <= 1;
+
+    if (opts.robots == 0)
+        opts.robots = paths;
+    return paths >= 1 && opts.robots >= 2 && opts.robots <= MAX_ROBOTS &&
+           opts.robots <= cells - obstacles;
 }
 
 //
 // =========================================================
-//  ARENA DISPLAY (Professor style)
+//  MATCH MODES
 // =========================================================
 //
 
-void print_arena(int round,
-                 int A_r, int A_c,
-                 int B_r, int B_c,
-                 const std::vector<RadarObj> &obstacles)
+void print_throughput(int matches, long long rounds, double secs)
 {
-    std::cout << "=========== starting round " << round << " ===========\n   ";
+    std::cout << matches / secs << " matches/sec | "
+              << rounds / secs << " rounds/sec\n";
+}
 
-    // column labels
-    for (int c = 0; c < BOARD_COLS; c++)
-        std::cout << std::setw(2) << c;
-    std::cout << "\n";
+// one match on this thread: printed live, drawn in place, or headless
+int run_single(const std::vector<const RobotLibrary *> &lineup, uint64_t seed, const ArenaOptions &opts)
+{
+    MatchOptions match_opts = opts.match;
+    std::unique_ptr<Spectator> spectator;
 
-    for (int r = 0; r < BOARD_ROWS; r++)
+    if (opts.render)
     {
-        std::cout << std::setw(2) << r << " ";
+        spectator = std::make_unique<Spectator>(match_opts.rows, match_opts.cols, opts.fps);
+        match_opts.spectator = spectator.get();
+    }
+    else
+        match_opts.live = !opts.headless;
 
-        for (int c = 0; c < BOARD_COLS; c++)
-        {
-            char ch = '.';
+    if (opts.record_path)
+        match_opts.record_path = opts.record_path;
 
-            // obstacles
-            for (auto &o : obstacles)
-                if (o.m_row == r && o.m_col == c)
-                    ch = o.m_type;
+    auto start = std::chrono::steady_clock::now();
+    MatchResult result = play_match(lineup, seed, match_opts);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if (spectator)
+        spectator->finish();
 
-            // robots overwrite obstacles visually
-            if (r == A_r && c == A_c) ch = 'A';
-            if (r == B_r && c == B_c) ch = 'B';
+    if (!match_opts.live)
+    {
+        if (result.stalemate)
+            std::cout << "stalemate after ";
+        else if (result.winner < 0)
+            std::cout << "draw after ";
+        else
+            std::cout << OccupancyGrid::robot_glyph(result.winner) << " ("
+                      << lineup[result.winner]->path << ") wins in ";
+        std::cout << result.rounds << " rounds | seed " << seed << " | ";
+        print_throughput(1, result.rounds, elapsed.count());
+    }
+    else
+        std::cout << "seed " << seed << "\n";
 
-            std::cout << " " << ch;
+    return 0;
+}
+
+// many headless matches spread over a fixed pool of worker threads. each
+// match gets freshly created robots, its own Rng and its own result slot, so
+// the workers share nothing but the (read-only) factories. match i is seeded
+// with seed + i and can be replayed alone with --seed.
+int run_batch(const std::vector<const RobotLibrary *> &lineup, int matches, int threads, uint64_t seed,
+              const MatchOptions &match_opts)
+{
+    std::vector<MatchResult> results(matches);
+    auto start = std::chrono::steady_clock::now();
+
+    {
+        ThreadPool pool(threads);
+        for (int i = 0; i < matches; i++)
+        {
+            pool.submit([&lineup, &results, &match_opts, i, seed]
+            {
+                results[i] = play_match(lineup, seed + i, match_opts);
+            });
         }
-        std::cout << "\n";
+        pool.wait();
+        threads = pool.size();
     }
-}
 
-//
-// =========================================================
-//  ROBOT LOADING
-// =========================================================
-//
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
 
-RobotBase *load_robot(const char *path, void *&handle)
-{
-    handle = dlopen(path, RTLD_LAZY);
-    if (!handle)
+    std::vector<int> wins(lineup.size(), 0);
+    int draws = 0;
+    int stalemates = 0;
+    long long rounds = 0;
+    for (const auto &result : results)
     {
-        std::cerr << "dlopen error: " << dlerror() << "\n";
-        return nullptr;
+        stalemates += result.stalemate;
+        if (result.winner < 0)
+            draws++;
+        else
+            wins[result.winner]++;
+        rounds += result.rounds;
     }
 
-    typedef RobotBase *(*CreateFn)();
-    CreateFn create_robot = (CreateFn)dlsym(handle, "create_robot");
+    std::cout << "wins:";
+    for (size_t i = 0; i < wins.size(); i++)
+        std::cout << " " << OccupancyGrid::robot_glyph(static_cast<int>(i)) << "=" << wins[i];
+    std::cout << " | draws: " << draws << " (" << stalemates << " stalemates) | " << matches << " matches on "
+              << threads << " threads | seeds " << seed << ".." << seed + matches - 1 << " | ";
+    print_throughput(matches, rounds, elapsed.count());
+    return 0;
+}
 
-    if (!create_robot)
+// loads the robots given on the command line and plays one match, a batch
+// or rollouts
+int run_matches(const ArenaOptions &opts)
+{
+    // load robots - each library is opened once and shared by every match
+    std::vector<RobotLibrary> libs(opts.robot_paths.size());
+    for (size_t i = 0; i < libs.size(); i++)
     {
-        std::cerr << "ERROR: create_robot() not found in " << path << "\n";
-        return nullptr;
+        if (!open_robot_library(opts.robot_paths[i], libs[i]))
+            return -1;
     }
 
-    return create_robot();
+    // the match lineup cycles through the libraries until --robots is filled
+    std::vector<const RobotLibrary *> lineup;
+    for (int i = 0; i < opts.robots; i++)
+        lineup.push_back(&libs[i % libs.size()]);
+
+    int rc;
+    if (opts.rollouts > 0)
+        rc = run_rollouts(lineup, opts.seed, opts.from_round, opts.rollouts, opts.threads, opts.match);
+    else if (opts.matches > 1 || opts.threads > 0)
+        rc = run_batch(lineup, opts.matches, opts.threads, opts.seed, opts.match);
+    else
+        rc = run_single(lineup, opts.seed, opts);
+
+    for (auto &lib : libs)
+        close_robot_library(lib);
+    return rc;
 }
 
 //
 // =========================================================
-//  MAIN ARENA LOOP
+//  MAIN
 // =========================================================
 //
 
 int main(int argc, char **argv)
 {
-    if (argc < 3)
+    // a child started by --sandbox to host one robot
+    if (argc == 3 && std::strcmp(argv[1], ROBOT_HOST_FLAG) == 0)
+        return run_robot_host(argv[2]);
+
+    ArenaOptions opts;
+    if (!parse_options(argc, argv, opts))
     {
-        std::cout << "Usage: ./RobotWarz robot1.so robot2.so\n";
+        print_usage();
         return 0;
     }
 
-    // load robots
-    void *h1 = nullptr, *h2 = nullptr;
-    RobotBase *A = load_robot(argv[1], h1);
-    RobotBase *B = load_robot(argv[2], h2);
-
-    if (!A || !B) return -1;
+    // every match folds its robots' call timings in here as it ends
+    CallProfiler profiler;
+    if (opts.profile)
+        opts.match.profiler = &profiler;
 
-    // boundaries
-    A->set_boundaries(BOARD_ROWS, BOARD_COLS);
-    B->set_boundaries(BOARD_ROWS, BOARD_COLS);
-
-    // starting locations
-    int A_r = 2,  A_c = 2;
-    int B_r = 17, B_c = 14;
-
-    A->move_to(A_r, A_c);
-    B->move_to(B_r, B_c);
-
-    // fixed arena obstacles
-    std::vector<RadarObj> obstacles =
-    {
-        {'M',12,11},
-        {'M',13,11},
-        {'M',14,11},
-        {'F', 6,14},
-        {'P',10, 1}
-    };
-
-    //
-    //  MAIN TURN LOOP
-    //
-    int round = 0;
-    while (true)
+    // and pushes its events here, for a thread of the log's own to write
+    EventLog events;
+    if (opts.events_path)
     {
-        print_arena(round, A_r, A_c, B_r, B_c, obstacles);
-
-        //
-        // ================= ROBOT A TURN =================
-        //
-        int scan_dir;
-        A->get_radar_direction(scan_dir);
-        auto radar_A = perform_radar_scan(A_r, A_c, scan_dir, obstacles, B_r, B_c);
-        A->process_radar_results(radar_A);
-
-        int shot_r, shot_c;
-        if (A->get_shot_location(shot_r, shot_c))
-        {
-            std::cout << "A SHOOTS at (" << shot_r << "," << shot_c << ")\n";
-            if (shot_hits_robot(shot_r, shot_c, B_r, B_c))
-            {
-                int dmg = get_weapon_damage(A->get_weapon());
-                std::cout << "B IS HIT! Damage = " << dmg << "\n";
-                B->take_damage(dmg);
-            }
-        }
-
-        //
-        // ================= ROBOT B TURN =================
-        //
-        B->get_radar_direction(scan_dir);
-        auto radar_B = perform_radar_scan(B_r, B_c, scan_dir, obstacles, A_r, A_c);
-        B->process_radar_results(radar_B);
-
-        if (B->get_shot_location(shot_r, shot_c))
-        {
-            std::cout << "B SHOOTS at (" << shot_r << "," << shot_c << ")\n";
-            if (shot_hits_robot(shot_r, shot_c, A_r, A_c))
-            {
-                int dmg = get_weapon_damage(B->get_weapon());
-                std::cout << "A IS HIT! Damage = " << dmg << "\n";
-                A->take_damage(dmg);
-            }
-        }
+        if (!events.open(opts.events_path, opts.events_format, opts.events_wait))
+            return -1;
+        opts.match.events = &events;
+    }
 
-        //
-        // ================= MOVEMENT =================
-        //
-        int move_dir, move_dist;
-        int dr[8] = {-1,-1,0,1,1,1,0,-1};
-        int dc[8] = { 0, 1,1,1,0,-1,-1,-1};
-
-        // A moves
-        A->get_move_direction(move_dir, move_dist);
-        A_r = std::clamp(A_r + dr[move_dir] * move_dist, 0, BOARD_ROWS - 1);
-        A_c = std::clamp(A_c + dc[move_dir] * move_dist, 0, BOARD_COLS - 1);
-        A->move_to(A_r, A_c);
-
-        // B moves
-        B->get_move_direction(move_dir, move_dist);
-        B_r = std::clamp(B_r + dr[move_dir] * move_dist, 0, BOARD_ROWS - 1);
-        B_c = std::clamp(B_c + dc[move_dir] * move_dist, 0, BOARD_COLS - 1);
-        B->move_to(B_r, B_c);
-
-        //
-        // ================= COLLISION =================
-        //
-        if (A_r == B_r && A_c == B_c)
-        {
-            std::cout << "COLLISION! Both robots take 1 damage.\n";
-            A->take_damage(1);
-            B->take_damage(1);
-        }
+    int rc;
+    if (opts.tournament)
+        rc = run_tournament(opts.robot_paths.empty() ? "." : opts.robot_paths[0],
+                            opts.seeds, opts.threads, opts.seed, opts.match);
+    else
+        rc = run_matches(opts);
 
-        //
-        // ================= WIN CHECK =================
-        //
-        if (A->get_health() <= 0)
-        {
-            std::cout << "\n===== B WINS! =====\n";
-            break;
-        }
-        if (B->get_health() <= 0)
-        {
-            std::cout << "\n===== A WINS! =====\n";
-            break;
-        }
+    events.close();
 
-        round++;
+    if (opts.profile && rc == 0)
+    {
+        profiler.print(std::cout);
+        if (opts.profile_csv && !profiler.write_csv(opts.profile_csv))
+            rc = -1;
     }
-
-    dlclose(h1);
-    dlclose(h2);
-    return 0;
+    return rc;
 }
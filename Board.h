@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include "RobotBase.h"
+#include "OccupancyGrid.h"
+#include "SparseGrid.h"
+
+// Board dimensions for the match core.
+//
+// The turn loop, movement and shot code are templates over one of these.
+// FixedBoard bakes the size in, so every bounds check and row*cols index
+// folds to constants; DynamicBoard carries the size at run time for
+// everything else. run_match() picks one from the requested size.
+//
+// Directions come from the directions[] table in RobotBase.h (index 0 is
+// "no direction", 1-8 go clockwise from up), which is constexpr and shared
+// by the radar and movement alike.
+
+template <int ROWS, int COLS>
+struct FixedBoard
+{
+    static_assert(ROWS > 0 && COLS > 0, "board needs at least one cell");
+
+    static constexpr int rows() { return ROWS; }
+    static constexpr int cols() { return COLS; }
+    static constexpr int cells() { return ROWS * COLS; }
+
+    static constexpr bool in_bounds(int row, int col)
+    {
+        // one unsigned compare per axis covers both ends
+        return static_cast<unsigned>(row) < static_cast<unsigned>(ROWS) &&
+               static_cast<unsigned>(col) < static_cast<unsigned>(COLS);
+    }
+
+    static constexpr int index(int row, int col) { return row * COLS + col; }
+};
+
+struct DynamicBoard
+{
+    int m_rows;
+    int m_cols;
+
+    int rows() const { return m_rows; }
+    int cols() const { return m_cols; }
+    int cells() const { return m_rows * m_cols; }
+
+    bool in_bounds(int row, int col) const
+    {
+        return static_cast<unsigned>(row) < static_cast<unsigned>(m_rows) &&
+               static_cast<unsigned>(col) < static_cast<unsigned>(m_cols);
+    }
+
+    int index(int row, int col) const { return row * m_cols + col; }
+};
+
+// the cell at (row, col), which must be on the board. the dense grid is
+// indexed through the board so that fixed sizes fold to constants.
+template <class Board>
+uint8_t cell_at(const Board &board, const OccupancyGrid &grid, int row, int col)
+{
+    return grid.at_index(board.index(row, col));
+}
+
+template <class Board>
+uint8_t cell_at(const Board &, const SparseGrid &grid, int row, int col)
+{
+    return grid.at(row, col);
+}
+
+// whether (row, col) is known to be empty without reading the cell: only a
+// tiled board can say so, a whole tile at a time
+inline bool in_empty_tile(const OccupancyGrid &, int, int) { return false; }
+inline bool in_empty_tile(const SparseGrid &grid, int row, int col) { return !grid.tile_occupied(row, col); }
+
+// the board sizes that get their own instantiation
+using SmallBoard = FixedBoard<10, 10>;
+using StandardBoard = FixedBoard<20, 20>;
+using LargeBoard = FixedBoard<64, 64>;
+
+// directions[] is what robots are written against; check the layout the
+// radar and movement rely on hasn't drifted
+static_assert(directions[0].first == 0 && directions[0].second == 0, "direction 0 is no movement");
+static_assert(directions[1].first == -1 && directions[1].second == 0, "direction 1 is up");
+static_assert(directions[3].first == 0 && directions[3].second == 1, "direction 3 is right");
+static_assert(directions[5].first == 1 && directions[5].second == 0, "direction 5 is down");
+static_assert(directions[7].first == 0 && directions[7].second == -1, "direction 7 is left");
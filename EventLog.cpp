@@ -0,0 +1,296 @@
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <climits>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "EventLog.h"
+
+// the most events written with one fwrite
+static const size_t DRAIN_BATCH = 4096;
+
+// a sleeping writer is woken once this many events are waiting, so that a
+// busy log costs one wake per batch rather than one per event
+static const uint64_t WAKE_BATCH = DRAIN_BATCH / 4;
+
+// the longest the writer sleeps without being woken: how long a trickle
+// of events too small to wake it may wait to be written
+static const long IDLE_WAIT_NS = 10 * 1000 * 1000;
+
+const char *event_name(EventType type)
+{
+    switch (type)
+    {
+        case EVENT_MATCH_START: return "match_start";
+        case EVENT_ROUND_START: return "round_start";
+        case EVENT_RADAR:       return "radar";
+        case EVENT_SHOT:        return "shot";
+        case EVENT_HIT:         return "hit";
+        case EVENT_MOVE:        return "move";
+        case EVENT_COLLISION:   return "collision";
+        case EVENT_DEATH:       return "death";
+        case EVENT_WIN:         return "win";
+        case EVENT_DRAW:        return "draw";
+        case EVENT_DROPPED:     return "dropped";
+        default:                return "?";
+    }
+}
+
+static const char *draw_reason_name(int reason)
+{
+    switch (reason)
+    {
+        case DRAW_NOBODY_LEFT: return "nobody_left";
+        case DRAW_STALEMATE:   return "stalemate";
+        case DRAW_ROUND_LIMIT: return "round_limit";
+        default:               return "?";
+    }
+}
+
+//
+// =========================================================
+//  JSON LINES
+// =========================================================
+//
+
+// one event as a line of JSON, appended to out
+static void append_json(std::string &out, const MatchEvent &e)
+{
+    char line[192];
+    if (e.type == EVENT_DROPPED)
+    {
+        // not from any one match
+        int n = std::snprintf(line, sizeof(line), "{\"event\":\"dropped\",\"count\":%d}\n", e.value);
+        out.append(line, n);
+        return;
+    }
+
+    int n = std::snprintf(line, sizeof(line), "{\"seed\":%" PRIu64 ",\"round\":%" PRIu32 ",\"event\":\"%s\"",
+                          e.seed, e.round, event_name(static_cast<EventType>(e.type)));
+
+    auto add = [&](const char *format, auto... args)
+    {
+        n += std::snprintf(line + n, sizeof(line) - n, format, args...);
+    };
+
+    switch (e.type)
+    {
+        case EVENT_MATCH_START:
+            add(",\"rows\":%d,\"cols\":%d,\"robots\":%d", e.row, e.col, e.value);
+            break;
+        case EVENT_RADAR:
+            add(",\"robot\":%d,\"dir\":%d,\"seen\":%d", e.robot, e.dir, e.value);
+            break;
+        case EVENT_SHOT:
+        case EVENT_DEATH:
+            add(",\"robot\":%d,\"row\":%d,\"col\":%d", e.robot, e.row, e.col);
+            break;
+        case EVENT_HIT:
+            add(",\"robot\":%d,\"by\":%d,\"damage\":%d", e.robot, e.other, e.value);
+            break;
+        case EVENT_MOVE:
+            add(",\"robot\":%d,\"dir\":%d,\"moved\":%d,\"row\":%d,\"col\":%d", e.robot, e.dir, e.value, e.row, e.col);
+            break;
+        case EVENT_COLLISION:
+            add(",\"robot\":%d,\"with\":%d", e.robot, e.other);
+            break;
+        case EVENT_WIN:
+            add(",\"robot\":%d,\"rounds\":%d", e.robot, e.value);
+            break;
+        case EVENT_DRAW:
+            add(",\"reason\":\"%s\",\"rounds\":%d", draw_reason_name(e.dir), e.value);
+            break;
+        default:
+            break;
+    }
+    add("}\n");
+    out.append(line, n);
+}
+
+//
+// =========================================================
+//  WAITING
+// =========================================================
+//
+
+static void futex_wait(std::atomic<uint32_t> &word, uint32_t seen, long timeout_ns)
+{
+    timespec timeout{timeout_ns / 1000000000, timeout_ns % 1000000000};
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT_PRIVATE, seen, &timeout, nullptr, 0);
+}
+
+static void futex_wake(std::atomic<uint32_t> &word, int count)
+{
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+}
+
+void EventLog::wake_writer()
+{
+    m_pushed.fetch_add(1);
+    futex_wake(m_pushed, 1);
+}
+
+// with wait_when_full, a push that found the queue full: hands the writer
+// the CPU until it makes room, and drops the event if it goes
+// EVENT_FULL_WAIT_MS without taking any. after that, events are dropped
+// without waiting until the writer moves again.
+void EventLog::push_full(const MatchEvent &event)
+{
+    const auto patience = std::chrono::milliseconds(EVENT_FULL_WAIT_MS);
+    auto give_up = std::chrono::steady_clock::now() + patience;
+    uint32_t drained = m_drained.load();
+
+    m_pushers_waiting.fetch_add(1);
+    bool pushed = false;
+    while (!pushed && !m_stuck.load())
+    {
+        uint32_t seen = m_drained.load();
+        if ((pushed = m_queue->try_push(event)))
+            break;
+
+        auto now = std::chrono::steady_clock::now();
+        if (seen != drained)
+        {
+            drained = seen;
+            give_up = now + patience;
+        }
+        else if (now >= give_up)
+        {
+            m_stuck.store(true);
+            break;
+        }
+
+        m_writer_waiting.store(0);
+        wake_writer();
+        futex_wait(m_drained, seen, std::chrono::duration_cast<std::chrono::nanoseconds>(give_up - now).count());
+    }
+    m_pushers_waiting.fetch_sub(1);
+
+    if (!pushed)
+        drop();
+}
+
+//
+// =========================================================
+//  WRITER
+// =========================================================
+//
+
+EventLog::~EventLog()
+{
+    close();
+}
+
+bool EventLog::open(const std::string &path, EventFormat format, bool wait_when_full)
+{
+    close();
+
+    m_file = std::fopen(path.c_str(), format == EVENTS_BINARY ? "wb" : "w");
+    if (!m_file)
+    {
+        std::cerr << "ERROR: can't create event file " << path << "\n";
+        return false;
+    }
+
+    m_format = format;
+    if (format == EVENTS_BINARY)
+    {
+        EventFileHeader header{};
+        std::memcpy(header.magic, EVENT_MAGIC, sizeof(header.magic));
+        header.version = EVENT_VERSION;
+        header.event_size = sizeof(MatchEvent);
+        std::fwrite(&header, sizeof(header), 1, m_file);
+    }
+
+    if (!m_queue)
+        m_queue = std::make_unique<MpscQueue<MatchEvent, EVENT_QUEUE_SIZE>>();
+    m_wait_when_full = wait_when_full;
+    m_batch.reserve(DRAIN_BATCH);
+    m_dropped = 0;
+    m_unreported = 0;
+    m_stuck = false;
+    m_written = 0;
+    m_stop = false;
+    m_writer = std::thread(&EventLog::writer_loop, this);
+    return true;
+}
+
+// takes up to a batch off the queue and writes it with one call, then
+// says how many events were dropped while the queue was full. returns how
+// many events the batch held.
+size_t EventLog::drain()
+{
+    m_batch.clear();
+    MatchEvent event;
+    while (m_batch.size() < DRAIN_BATCH && m_queue->try_pop(event))
+        m_batch.push_back(event);
+    size_t taken = m_batch.size();
+
+    if (taken > 0)
+    {
+        m_stuck.store(false);
+        m_drained.fetch_add(1);
+        if (m_pushers_waiting.load())
+            futex_wake(m_drained, INT_MAX);
+    }
+
+    for (long long lost = m_unreported.exchange(0); lost > 0; lost -= INT32_MAX)
+        m_batch.push_back({0, 0, EVENT_DROPPED, -1, -1, 0, 0, 0,
+                           static_cast<int32_t>(std::min<long long>(lost, INT32_MAX))});
+    if (m_batch.empty())
+        return 0;
+
+    if (m_format == EVENTS_BINARY)
+        std::fwrite(m_batch.data(), sizeof(MatchEvent), m_batch.size(), m_file);
+    else
+    {
+        m_text.clear();
+        for (const auto &e : m_batch)
+            append_json(m_text, e);
+        std::fwrite(m_text.data(), 1, m_text.size(), m_file);
+    }
+    m_written += static_cast<long long>(taken);
+    return taken;
+}
+
+// sleeps on m_pushed whenever the queue is empty. it says so first and
+// then looks once more, so events pushed in between aren't left waiting
+// for the timeout.
+void EventLog::writer_loop()
+{
+    while (!m_stop.load())
+    {
+        uint32_t seen = m_pushed.load();
+        if (drain() > 0)
+            continue;
+
+        m_wake_at.store(m_queue->popped() + WAKE_BATCH, std::memory_order_relaxed);
+        m_writer_waiting.store(1);
+        if (drain() == 0 && !m_stop.load())
+            futex_wait(m_pushed, seen, IDLE_WAIT_NS);
+        m_writer_waiting.store(0);
+    }
+    while (drain() > 0)
+    {
+    }
+}
+
+void EventLog::close()
+{
+    if (!m_file)
+        return;
+
+    m_stop = true;
+    wake_writer();
+    m_writer.join();
+    std::fclose(m_file);
+    m_file = nullptr;
+
+    if (m_dropped > 0)
+        std::cerr << "WARNING: the event writer fell behind; " << m_dropped << " of "
+                  << m_written + m_dropped << " events were dropped\n";
+}
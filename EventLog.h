@@ -0,0 +1,206 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "MpscQueue.h"
+
+// Structured match events (--events).
+//
+// Matches push fixed-size events into a lock-free queue and a writer
+// thread drains it in batches to a file, so a match never waits on the
+// disk. Matches on any number of threads can share one log; every event
+// carries its match's seed. If the writer falls behind far enough for the
+// queue to fill, events are dropped and counted rather than held up, and
+// the writer says how many in a dropped record once it catches up.
+//
+// A log opened with wait_when_full (--events-wait) makes matches wait for
+// room instead, for as long as the writer keeps taking events. Only once
+// it has gone EVENT_FULL_WAIT_MS without taking any are events dropped.
+//
+// Two formats:
+//
+//     jsonl   one JSON object per line, e.g.
+//             {"seed":7,"round":12,"event":"hit","robot":1,"by":0,"damage":14}
+//             robots are given by index, as in the match lineup. lost
+//             events show up as {"event":"dropped","count":N}
+//     binary  an EventFileHeader followed by raw MatchEvents, little-endian
+//             and unpadded. lost events show up as an EVENT_DROPPED
+
+enum EventType : uint8_t
+{
+    EVENT_MATCH_START,   // row, col = board size, value = robots
+    EVENT_ROUND_START,
+    EVENT_RADAR,         // robot scanned dir and saw value objects
+    EVENT_SHOT,          // robot fired at (row, col)
+    EVENT_HIT,           // robot took value damage from other's shot
+    EVENT_MOVE,          // robot asked for dir and went value cells, ending on (row, col)
+    EVENT_COLLISION,     // robot ran into other; both take 1 damage
+    EVENT_DEATH,         // robot was destroyed on (row, col)
+    EVENT_WIN,           // robot is the last one standing, value = rounds played
+    EVENT_DRAW,          // value = rounds played, dir = the DrawReason
+    EVENT_DROPPED,       // value events were lost before this point; seed and round are 0
+    EVENT_TYPE_COUNT
+};
+
+enum DrawReason : int8_t
+{
+    DRAW_NOBODY_LEFT,
+    DRAW_STALEMATE,
+    DRAW_ROUND_LIMIT
+};
+
+const char *event_name(EventType type);
+
+static const char EVENT_MAGIC[4] = {'R', 'W', 'Z', 'E'};
+static const uint16_t EVENT_VERSION = 1;
+
+#pragma pack(push, 1)
+
+struct EventFileHeader
+{
+    char magic[4];
+    uint16_t version;
+    uint16_t event_size;   // sizeof(MatchEvent), so readers can skip fields they don't know
+};
+
+// what isn't used by an event's type is 0, or -1 for robots
+struct MatchEvent
+{
+    uint64_t seed;
+    uint32_t round;
+    uint8_t type;     // EventType
+    int8_t robot;     // index in the lineup
+    int8_t other;
+    int8_t dir;
+    int16_t row;
+    int16_t col;
+    int32_t value;
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(MatchEvent) == 24, "match event layout changed");
+
+enum EventFormat
+{
+    EVENTS_JSONL,
+    EVENTS_BINARY
+};
+
+// events waiting for the writer; at 24 bytes each this is 6 MB
+static const uint32_t EVENT_QUEUE_SIZE = 1 << 18;
+
+// with wait_when_full, how long a match waits for room in a full queue,
+// with the writer taking nothing off it, before dropping an event
+static const int EVENT_FULL_WAIT_MS = 10;
+
+// the file and the thread writing it, shared by every match
+class EventLog
+{
+private:
+    // made by the first open(), so a log that is never opened costs nothing
+    std::unique_ptr<MpscQueue<MatchEvent, EVENT_QUEUE_SIZE>> m_queue;
+    bool m_wait_when_full = false;
+    std::atomic<long long> m_dropped{0};
+    std::atomic<long long> m_unreported{0};   // dropped since the last dropped record
+    std::atomic<bool> m_stop{false};
+    std::thread m_writer;
+
+    // futex words. the writer sleeps on m_pushed when the queue is empty,
+    // and with wait_when_full matches sleep on m_drained when it is full.
+    // each side only makes the wake syscall when the other says someone is
+    // asleep. a sleeping writer is only woken once a batch is waiting for
+    // it (m_wake_at), and only by the first match to see that.
+    alignas(64) std::atomic<uint32_t> m_pushed{0};
+    std::atomic<uint32_t> m_writer_waiting{0};
+    std::atomic<uint64_t> m_wake_at{0};
+    alignas(64) std::atomic<uint32_t> m_drained{0};
+    std::atomic<uint32_t> m_pushers_waiting{0};
+    std::atomic<bool> m_stuck{false};   // a match gave up waiting; drop until the writer moves
+
+    // the writer thread's, between open() and close()
+    std::FILE *m_file = nullptr;
+    EventFormat m_format = EVENTS_JSONL;
+    std::vector<MatchEvent> m_batch;
+    std::string m_text;
+    long long m_written = 0;
+
+    void writer_loop();
+    size_t drain();
+    void wake_writer();
+    void push_full(const MatchEvent &event);
+
+    void drop()
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        m_unreported.fetch_add(1, std::memory_order_relaxed);
+    }
+
+public:
+    EventLog() = default;
+    ~EventLog();
+
+    EventLog(const EventLog &) = delete;
+    EventLog &operator=(const EventLog &) = delete;
+
+    // creates path and starts the writer. with wait_when_full, a push into
+    // a full queue waits for the writer rather than dropping the event.
+    // prints the reason and returns false on failure.
+    bool open(const std::string &path, EventFormat format, bool wait_when_full = false);
+
+    // writes out whatever is queued and stops the writer. warns if any
+    // events were dropped.
+    void close();
+
+    bool is_open() const { return m_file != nullptr; }
+
+    // any thread, while open. never blocks unless opened with
+    // wait_when_full.
+    void push(const MatchEvent &event)
+    {
+        uint64_t place;
+        if (!m_queue->try_push(event, &place))
+        {
+            if (m_wait_when_full)
+                push_full(event);
+            else
+                drop();
+        }
+        else if (m_writer_waiting.load() && place >= m_wake_at.load(std::memory_order_relaxed) &&
+                 m_writer_waiting.exchange(0))
+            wake_writer();
+    }
+
+    long long dropped() const { return m_dropped.load(); }
+    long long written() const { return m_written; }
+};
+
+// the events of one match: it knows the seed and the round, so the arena
+// only says what happened. with no log every call is a single test.
+class MatchEvents
+{
+private:
+    EventLog *m_log;
+    uint64_t m_seed;
+    uint32_t m_round = 0;
+
+public:
+    MatchEvents(EventLog *log, uint64_t seed) : m_log(log), m_seed(seed) {}
+
+    bool enabled() const { return m_log != nullptr; }
+    void set_round(int round) { m_round = static_cast<uint32_t>(round); }
+
+    void emit(EventType type, int robot = -1, int other = -1, int dir = 0, int row = 0, int col = 0,
+              int value = 0)
+    {
+        if (!m_log)
+            return;
+        m_log->push({m_seed, m_round, type, static_cast<int8_t>(robot), static_cast<int8_t>(other),
+                     static_cast<int8_t>(dir), static_cast<int16_t>(row), static_cast<int16_t>(col), value});
+    }
+};
@@ -0,0 +1,791 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <iomanip>
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <filesystem>
+#include "Match.h"
+#include "RadarObj.h"
+#include "OccupancyGrid.h"
+#include "SparseGrid.h"
+#include "Radar.h"
+#include "Replay.h"
+#include "Board.h"
+#include "Shot.h"
+#include "Stalemate.h"
+#include "Watchdog.h"
+#include "Sandbox.h"
+
+//
+// =========================================================
+//  WEAPON DAMAGE TABLE  (ranges from the spec)
+// =========================================================
+//
+
+int get_weapon_damage(WeaponType w, Rng &rng)
+{
+    switch (w)
+    {
+        case flamethrower: return rng.range(30, 50);
+        case railgun:      return rng.range(10, 20);
+        case grenade:      return rng.range(10, 40);
+        case hammer:       return rng.range(50, 60);
+        default:           return 0;
+    }
+}
+
+//
+// =========================================================
+//  ARENA DISPLAY (Professor style)
+// =========================================================
+//
+
+void print_arena(int round, const OccupancyGrid &grid)
+{
+    std::cout << "=========== starting round " << round << " ===========\n   ";
+
+    // column labels
+    for (int c = 0; c < grid.cols(); c++)
+        std::cout << std::setw(2) << c;
+    std::cout << "\n";
+
+    for (int r = 0; r < grid.rows(); r++)
+    {
+        std::cout << std::setw(2) << r << " ";
+
+        for (int c = 0; c < grid.cols(); c++)
+        {
+            std::cout << " " << OccupancyGrid::display_char(grid.at(r, c));
+        }
+        std::cout << "\n";
+    }
+}
+
+void print_arena(int round, const SparseGrid &grid)
+{
+    std::cout << "=========== starting round " << round << " ===========  ("
+              << grid.rows() << "x" << grid.cols() << ", "
+              << grid.allocated_tiles() << " of " << grid.tile_rows() * grid.tile_cols()
+              << " tiles in use)\n";
+}
+
+//
+// =========================================================
+//  ROBOT TABLE
+// =========================================================
+//
+
+// per-robot match state, one array per field. the per-round passes mostly
+// touch just positions and alive flags, and with dozens of robots those stay
+// packed together in cache instead of being spread across robot objects.
+struct RobotTable
+{
+    std::vector<RobotBase *> robot;
+    std::vector<int> row;
+    std::vector<int> col;
+    std::vector<uint8_t> alive;
+    std::vector<char> glyph;
+    std::vector<SandboxedRobot *> sandboxed;   // null for robots in this process
+    std::vector<std::string> name;             // as the robot called itself when the match began
+
+    // the arena's own copy of what it has done to each robot. a robot the
+    // watchdog left running an overrun call is stuck: its object is
+    // another thread's until the call comes back, so what it is owed waits
+    // until then and everything else reads it from here.
+    std::vector<int> health;
+    std::vector<int> armor;
+    std::vector<uint8_t> stuck;
+    std::vector<int> owed_damage;
+    std::vector<int> owed_armor;
+
+    int size() const { return static_cast<int>(robot.size()); }
+};
+
+// applies damage and, if that kills the robot, leaves its wreck on the board
+template <class Grid>
+static void damage_robot(RobotTable &table, Grid &grid, int index, int damage, bool live, MatchEvents &events)
+{
+    table.health[index] = std::max(0, table.health[index] - damage);
+    if (table.stuck[index])
+        table.owed_damage[index] += damage;
+    else
+        table.robot[index]->take_damage(damage);
+
+    if (table.health[index] > 0 || !table.alive[index])
+        return;
+
+    table.alive[index] = 0;
+    grid.kill_robot(table.row[index], table.col[index]);
+    events.emit(EVENT_DEATH, index, -1, 0, table.row[index], table.col[index]);
+    if (live)
+        std::cout << table.glyph[index] << " (" << table.name[index] << ") IS DESTROYED!\n";
+}
+
+// a point of armor lost to a hit
+static void wear_armor(RobotTable &table, int index)
+{
+    table.armor[index] = std::max(0, table.armor[index] - 1);
+    if (table.stuck[index])
+        table.owed_armor[index]++;
+    else
+        table.robot[index]->reduce_armor(1);
+}
+
+// a stuck robot whose call has come back is the match's again; it takes
+// what it was owed before anything else
+static void settle_robot(RobotTable &table, const TurnWatchdog &watchdog, int index)
+{
+    if (!table.stuck[index] || watchdog.busy(index))
+        return;
+
+    RobotBase *robot = table.robot[index];
+    if (table.owed_damage[index] > 0)
+        robot->take_damage(table.owed_damage[index]);
+    if (table.owed_armor[index] > 0)
+        robot->reduce_armor(table.owed_armor[index]);
+    table.owed_damage[index] = 0;
+    table.owed_armor[index] = 0;
+    table.stuck[index] = 0;
+}
+
+// the status line the viewer shows under the board
+static std::string robot_status(const RobotTable &table, int index)
+{
+    if (!table.stuck[index])
+        return table.robot[index]->print_stats();
+    return table.name[index] + ":   H: " + std::to_string(table.health[index]) +
+           "  A: " + std::to_string(table.armor[index]) + "  at: (" + std::to_string(table.row[index]) + "," +
+           std::to_string(table.col[index]) + ")  not answering";
+}
+
+//
+// =========================================================
+//  MOVEMENT
+// =========================================================
+//
+
+// steps the robot one cell at a time toward the destination it asked for.
+// mounds, wrecks and the board edge stop it; running into another robot
+// stops it and both take 1 damage; a pit traps it; a flamethrower burns it
+// on the way through.
+template <class Board, class Grid>
+static void move_robot(const Board &board, Grid &grid, RobotTable &table, int index,
+                       int move_dir, int move_dist, Rng &rng, bool live, MatchEvents &events)
+{
+    RobotBase *robot = table.robot[index];
+
+    if (move_dir < 1 || move_dir > 8)
+        return;
+
+    // robots may ask for more than they are allowed
+    move_dist = std::min(move_dist, robot->get_move_speed());
+
+    int dr = directions[move_dir].first;
+    int dc = directions[move_dir].second;
+    int &row = table.row[index];
+    int &col = table.col[index];
+    int moved = 0;
+
+    for (int step = 0; step < move_dist && table.alive[index]; step++)
+    {
+        int r = row + dr;
+        int c = col + dc;
+
+        if (!board.in_bounds(r, c))
+            break;
+
+        uint8_t cell = cell_at(board, grid, r, c);
+
+        if (OccupancyGrid::is_robot(cell))
+        {
+            if (live)
+                std::cout << "COLLISION! " << table.glyph[index] << " and "
+                          << table.glyph[OccupancyGrid::robot_index(cell)] << " take 1 damage.\n";
+            events.emit(EVENT_COLLISION, index, OccupancyGrid::robot_index(cell));
+            damage_robot(table, grid, index, 1, live, events);
+            damage_robot(table, grid, OccupancyGrid::robot_index(cell), 1, live, events);
+            break;
+        }
+        if (cell == 'M' || cell == 'X')
+            break;
+
+        grid.move_robot(index, row, col, r, c);
+        row = r;
+        col = c;
+        moved++;
+
+        if (cell == 'P')
+        {
+            robot->disable_movement();
+            break;
+        }
+        if (cell == 'F')
+            damage_robot(table, grid, index, get_weapon_damage(flamethrower, rng), live, events);
+    }
+
+    robot->move_to(row, col);
+    events.emit(EVENT_MOVE, index, -1, move_dir, row, col, moved);
+}
+
+//
+// =========================================================
+//  SHOTS
+// =========================================================
+//
+
+// everything the shot covers takes its own damage roll, cut by that
+// robot's armor, and then loses a point of armor. a grenade launcher with
+// no grenades left does nothing.
+template <class Board, class Grid>
+static void resolve_shot(const Board &board, Grid &grid, RobotTable &table, int shooter,
+                         int shot_r, int shot_c, std::vector<int> &targets, Rng &rng,
+                         bool live, MatchEvents &events, ReplayRobot &rec)
+{
+    RobotBase *robot = table.robot[shooter];
+    WeaponType weapon = robot->get_weapon();
+
+    if (weapon == grenade)
+    {
+        if (robot->get_grenades() <= 0)
+            return;
+        robot->decrement_grenades();
+    }
+
+    targets.clear();
+    find_shot_targets(board, grid, shooter, weapon, table.row[shooter], table.col[shooter],
+                      shot_r, shot_c, targets);
+
+    int total = 0;
+    for (int target : targets)
+    {
+        int dmg = armor_reduced_damage(get_weapon_damage(weapon, rng), table.armor[target]);
+        if (live)
+            std::cout << table.glyph[target] << " IS HIT! Damage = " << dmg << "\n";
+        events.emit(EVENT_HIT, target, shooter, 0, 0, 0, dmg);
+        damage_robot(table, grid, target, dmg, live, events);
+        wear_armor(table, target);
+        total += dmg;
+    }
+
+    rec.hits = static_cast<int8_t>(std::min<size_t>(targets.size(), INT8_MAX));
+    rec.damage = static_cast<int16_t>(std::min(total, INT16_MAX));
+}
+
+//
+// =========================================================
+//  REPLAY RECORDING
+// =========================================================
+//
+
+static void open_replay(ReplayWriter &recorder, const MatchOptions &opts,
+                        const RobotTable &table, const std::vector<RadarObj> &obstacles)
+{
+    ReplayHeader header{};
+    std::memcpy(header.magic, REPLAY_MAGIC, sizeof(header.magic));
+    header.version = REPLAY_VERSION;
+    header.rows = static_cast<uint16_t>(opts.rows);
+    header.cols = static_cast<uint16_t>(opts.cols);
+    header.robot_count = static_cast<uint16_t>(table.size());
+    header.obstacle_count = static_cast<uint16_t>(obstacles.size());
+    header.seed = opts.seed;
+
+    std::vector<ReplayRobotInfo> infos(table.size());
+    for (int i = 0; i < table.size(); i++)
+    {
+        std::strncpy(infos[i].name, table.robot[i]->m_name.c_str(), sizeof(infos[i].name));
+        infos[i].start_row = static_cast<int16_t>(table.row[i]);
+        infos[i].start_col = static_cast<int16_t>(table.col[i]);
+    }
+
+    std::vector<ReplayObstacle> obs;
+    for (const auto &ob : obstacles)
+        obs.push_back({ob.m_type, static_cast<int16_t>(ob.m_row), static_cast<int16_t>(ob.m_col)});
+
+    recorder.open(opts.record_path, header, infos.data(), obs.data());
+}
+
+// end-of-round state that the turn code doesn't already fill in. the
+// replay tells the dead by their health, so a robot the arena took out
+// with health left (disqualified, or its sandbox crashed) is written as 0.
+static void finish_replay_record(ReplayRobot &rec, const RobotTable &table, int index)
+{
+    rec.row = static_cast<int16_t>(table.row[index]);
+    rec.col = static_cast<int16_t>(table.col[index]);
+    rec.health = static_cast<int16_t>(table.alive[index] ? table.health[index] : 0);
+    rec.armor = static_cast<int8_t>(table.armor[index]);
+}
+
+//
+// =========================================================
+//  MATCH
+// =========================================================
+//
+
+int obstacle_count(int rows, int cols, int obstacles)
+{
+    return obstacles < 0 ? rows * cols / 80 : obstacles;
+}
+
+// starting capacity of each robot's radar buffer; a ray across a 20x20
+// board with its obstacles and robots rarely reports more
+static const size_t RADAR_RESERVE = 64;
+
+// a random empty cell. the caller makes sure there is one.
+template <class Board, class Grid>
+static void random_empty_cell(const Board &board, const Grid &grid, Rng &rng, int &r, int &c)
+{
+    do
+    {
+        r = rng.below(board.rows());
+        c = rng.below(board.cols());
+    } while (cell_at(board, grid, r, c) != CELL_EMPTY);
+}
+
+static void radar_scan(const OccupancyGrid &grid, const RadarMasks *masks,
+                       int row, int col, int direction, std::vector<RadarObj> &results)
+{
+    perform_radar_scan(grid, masks, row, col, direction, results);
+}
+
+static void radar_scan(const SparseGrid &grid, const RadarMasks *,
+                       int row, int col, int direction, std::vector<RadarObj> &results)
+{
+    perform_radar_scan(grid, row, col, direction, results);
+}
+
+// a frame for the spectator, if there is one and it has asked for one;
+// the last board of a match is always sent. tiled boards are too big to
+// draw; the arena doesn't allow it.
+template <class Grid>
+static void spectate(int round, const Grid &grid, const RobotTable &table, const MatchOptions &opts, bool last)
+{
+    if constexpr (std::is_same_v<Grid, OccupancyGrid>)
+    {
+        if (opts.spectator && (last || opts.spectator->wants_frame()))
+            opts.spectator->publish(round, grid, table.size(),
+                                    [&](int i) { return robot_status(table, i); });
+    }
+}
+
+// one call into robot i, timed and watched. false if the robot took too
+// long and forfeits the call; one that has done that too often, or whose
+// sandbox process has died, is taken out on the spot and left on the board
+// as a wreck.
+template <class Grid>
+static bool call_robot(RobotTable &table, Grid &grid, TurnWatchdog &watchdog, MatchProfile &profile,
+                       MatchEvents &events, const MatchOptions &opts, int i, RobotCallback which,
+                       RobotCall &call)
+{
+    settle_robot(table, watchdog, i);
+
+    bool answered = false;
+    profile.time(i, which, [&] { answered = watchdog.run(i, which, call); });
+
+    // the robot may still be running, so it is only named, never asked
+    auto name = [&]() -> const char *
+    {
+        return i < static_cast<int>(opts.robot_names.size()) ? opts.robot_names[i].c_str() : "?";
+    };
+
+    SandboxedRobot *sandboxed = table.sandboxed[i];
+    if (sandboxed && sandboxed->crashed())
+    {
+        if (table.alive[i])
+        {
+            table.alive[i] = 0;
+            grid.kill_robot(table.row[i], table.col[i]);
+            events.emit(EVENT_DEATH, i, -1, 0, table.row[i], table.col[i]);
+            std::cerr << "seed " << opts.seed << ": " << table.glyph[i] << " (" << name() << ") CRASHED in "
+                      << callback_name(which) << " (" << sandboxed->crash_reason() << ")\n";
+        }
+        return false;
+    }
+    if (answered)
+        return true;
+    table.stuck[i] = watchdog.busy(i);
+    std::cerr << "seed " << opts.seed << ": " << table.glyph[i] << " (" << name() << ") overran "
+              << callback_name(which) << " (budget " << opts.turn_budget_ms << " ms), call forfeited\n";
+
+    if (watchdog.disqualified(i) && table.alive[i])
+    {
+        table.alive[i] = 0;
+        grid.kill_robot(table.row[i], table.col[i]);
+        events.emit(EVENT_DEATH, i, -1, 0, table.row[i], table.col[i]);
+        std::cerr << "seed " << opts.seed << ": " << table.glyph[i] << " (" << name() << ") DISQUALIFIED after "
+                  << watchdog.overruns(i) << " overruns\n";
+    }
+    return false;
+}
+
+// the profiler's row for each robot: its library if play_match named it,
+// otherwise whatever the robot calls itself
+static std::vector<std::string> profile_names(const RobotTable &table, const MatchOptions &opts)
+{
+    std::vector<std::string> names;
+    if (!opts.profiler)
+        return names;
+
+    for (int i = 0; i < table.size(); i++)
+        names.push_back(i < static_cast<int>(opts.robot_names.size()) ? opts.robot_names[i]
+                                                                       : table.robot[i]->m_name);
+    return names;
+}
+
+// copies the match into opts.paused, for a MatchOptions::pause_round
+static void pause_match(const OccupancyGrid &grid, const RobotTable &table,
+                        const std::vector<RadarObj> &obstacles, int round, const Rng &rng,
+                        const StalemateDetector &stalemate, ArenaState &state)
+{
+    state.round = round;
+    state.grid = grid;
+    state.obstacles = obstacles;
+    state.rng = rng;
+    state.stalemate = stalemate;
+
+    state.robots.clear();
+    for (int i = 0; i < table.size(); i++)
+    {
+        RobotBase *robot = table.robot[i];
+        state.robots.push_back({table.row[i], table.col[i], table.alive[i] != 0, table.glyph[i],
+                                table.health[i], table.armor[i], robot->get_grenades(),
+                                robot->get_move_speed()});
+    }
+}
+
+// plays a match from round 0, or from a paused state if resume is set
+template <class Grid, class Board>
+static MatchResult run_match_on(const Board &board, std::vector<RobotBase *> &robots,
+                                Rng &rng, const MatchOptions &opts, const ArenaState *resume = nullptr)
+{
+    bool live = opts.live;
+    int count = static_cast<int>(robots.size());
+
+    Grid grid(board.rows(), board.cols());
+    std::vector<RadarObj> obstacles;
+    int first_round = 0;
+
+    RobotTable table;
+    table.robot = robots;
+    table.row.resize(count);
+    table.col.resize(count);
+    table.alive.assign(count, 1);
+    table.glyph.resize(count);
+    for (auto *robot : robots)
+    {
+        table.sandboxed.push_back(dynamic_cast<SandboxedRobot *>(robot));
+        table.name.push_back(robot->m_name);
+        table.health.push_back(robot->get_health());
+        table.armor.push_back(robot->get_armor());
+    }
+    table.stuck.assign(count, 0);
+    table.owed_damage.assign(count, 0);
+    table.owed_armor.assign(count, 0);
+
+    if constexpr (std::is_same_v<Grid, OccupancyGrid>)
+    {
+        if (resume)
+        {
+            grid = resume->grid;
+            obstacles = resume->obstacles;
+            first_round = resume->round;
+            for (int i = 0; i < count; i++)
+            {
+                const RobotState &was = resume->robots[i];
+                table.row[i] = was.row;
+                table.col[i] = was.col;
+                table.alive[i] = was.alive;
+                table.glyph[i] = was.glyph;
+
+                // the copies know where they are; this is for robots that don't copy that
+                RobotBase *robot = table.robot[i];
+                robot->m_character = was.glyph;
+                robot->set_boundaries(board.rows(), board.cols());
+                robot->move_to(was.row, was.col);
+            }
+        }
+    }
+
+    if (!resume)
+    {
+        //
+        // obstacles are scattered first: three mounds for every pit and
+        // flamethrower, like the original map
+        //
+        obstacles.resize(obstacle_count(board.rows(), board.cols(), opts.obstacles));
+        for (auto &ob : obstacles)
+        {
+            static const char types[] = {'M', 'M', 'M', 'P', 'F'};
+            ob.m_type = types[rng.below(sizeof(types))];
+            random_empty_cell(board, grid, rng, ob.m_row, ob.m_col);
+            grid.place_obstacle(ob.m_type, ob.m_row, ob.m_col);
+        }
+
+        //
+        // robots go on random empty cells
+        //
+        for (int i = 0; i < count; i++)
+        {
+            int r, c;
+            random_empty_cell(board, grid, rng, r, c);
+
+            table.row[i] = r;
+            table.col[i] = c;
+            table.glyph[i] = OccupancyGrid::robot_glyph(i);
+
+            RobotBase *robot = table.robot[i];
+            robot->m_character = table.glyph[i];
+            robot->set_boundaries(board.rows(), board.cols());
+            robot->move_to(r, c);
+            grid.place_robot(i, r, c);
+        }
+    }
+
+    const RadarMasks *radar_masks = RadarMasks::for_board(board.rows(), board.cols());
+
+    ReplayWriter recorder;
+    std::vector<ReplayRobot> rec(count);
+    if (!opts.record_path.empty() && !resume)
+        open_replay(recorder, opts, table, obstacles);
+
+    int alive_count = count;
+    std::vector<int> targets;
+    targets.reserve(count);   // a shot hits each robot at most once
+    StalemateDetector stalemate = resume ? resume->stalemate
+                                         : StalemateDetector(opts.stalemate_repeats, count, opts.max_rounds);
+    MatchProfile profile(opts.profiler, profile_names(table, opts));
+    TurnWatchdog watchdog(robots, opts.robot_rngs, opts.turn_budget_ms, opts.max_overruns);
+    MatchEvents events(opts.events, opts.seed);
+    events.set_round(first_round);
+    if (!resume)
+        events.emit(EVENT_MATCH_START, -1, -1, 0, board.rows(), board.cols(), count);
+
+    // one call buffer per robot, radar results included. they are refilled
+    // in place every round, so once each has seen its largest scan the turn
+    // loop stops touching the heap.
+    std::vector<RobotCall> calls(count);
+    for (auto &call : calls)
+        call.radar.reserve(RADAR_RESERVE);
+
+    // --pace: round k of this call starts no sooner than k round times in
+    auto pace_start = std::chrono::steady_clock::now();
+    std::chrono::duration<double> round_time(opts.rounds_per_sec > 0 ? 1.0 / opts.rounds_per_sec : 0.0);
+
+    //
+    //  MAIN TURN LOOP
+    //
+    for (int round = first_round; round < opts.max_rounds; round++)
+    {
+        if (opts.rounds_per_sec > 0)
+            std::this_thread::sleep_until(pace_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                                           round_time * (round - first_round)));
+
+        if constexpr (std::is_same_v<Grid, OccupancyGrid>)
+        {
+            if (opts.paused && round == opts.pause_round && !resume)
+            {
+                pause_match(grid, table, obstacles, round, rng, stalemate, *opts.paused);
+                return {MATCH_PAUSED, round};
+            }
+        }
+
+        spectate(round, grid, table, opts, false);
+        if (live && !opts.spectator)
+            print_arena(round, grid);
+        events.set_round(round);
+        events.emit(EVENT_ROUND_START);
+
+        std::fill(rec.begin(), rec.end(), ReplayRobot{});
+
+        //
+        // ================= RADAR AND SHOTS =================
+        //
+        for (int i = 0; i < count; i++)
+        {
+            if (!table.alive[i])
+                continue;
+
+            RobotCall &call = calls[i];
+            if (!call_robot(table, grid, watchdog, profile, events, opts, i, CALL_RADAR_DIRECTION, call))
+                continue;
+            int scan_dir = call.first;
+            rec[i].radar_dir = static_cast<int8_t>(scan_dir);
+
+            radar_scan(grid, radar_masks, table.row[i], table.col[i], scan_dir, call.radar);
+            events.emit(EVENT_RADAR, i, -1, scan_dir, 0, 0, static_cast<int>(call.radar.size()));
+            if (!call_robot(table, grid, watchdog, profile, events, opts, i, CALL_PROCESS_RADAR, call))
+                continue;
+
+            if (!call_robot(table, grid, watchdog, profile, events, opts, i, CALL_SHOT_LOCATION, call) || !call.shoots)
+                continue;
+            int shot_r = call.first;
+            int shot_c = call.second;
+
+            rec[i].shot = 1;
+            rec[i].shot_row = static_cast<int16_t>(shot_r);
+            rec[i].shot_col = static_cast<int16_t>(shot_c);
+            if (live)
+                std::cout << table.glyph[i] << " SHOOTS at (" << shot_r << "," << shot_c << ")\n";
+            events.emit(EVENT_SHOT, i, -1, 0, shot_r, shot_c);
+
+            resolve_shot(board, grid, table, i, shot_r, shot_c, targets, rng, live, events, rec[i]);
+        }
+
+        //
+        // ================= MOVEMENT / COLLISION =================
+        //
+        for (int i = 0; i < count; i++)
+        {
+            if (!table.alive[i])
+                continue;
+
+            RobotCall &call = calls[i];
+            if (!call_robot(table, grid, watchdog, profile, events, opts, i, CALL_MOVE_DIRECTION, call))
+                continue;
+            int move_dir = call.first;
+            int move_dist = call.second;
+            rec[i].move_dir = static_cast<int8_t>(move_dir);
+            rec[i].move_dist = static_cast<int8_t>(move_dist);
+            move_robot(board, grid, table, i, move_dir, move_dist, rng, live, events);
+        }
+
+        if (recorder.is_open())
+        {
+            for (int i = 0; i < count; i++)
+                finish_replay_record(rec[i], table, i);
+            recorder.append(static_cast<uint32_t>(round), rec.data());
+        }
+
+        //
+        // ================= WIN CHECK =================
+        //
+        alive_count = 0;
+        int last_alive = -1;
+        for (int i = 0; i < count; i++)
+        {
+            if (table.alive[i])
+            {
+                alive_count++;
+                last_alive = i;
+            }
+        }
+
+        if (alive_count <= 1)
+        {
+            spectate(round + 1, grid, table, opts, true);
+            if (last_alive >= 0)
+                events.emit(EVENT_WIN, last_alive, -1, 0, 0, 0, round + 1);
+            else
+                events.emit(EVENT_DRAW, -1, -1, DRAW_NOBODY_LEFT, 0, 0, round + 1);
+            if (live && last_alive >= 0)
+                std::cout << "\n===== " << table.glyph[last_alive] << " ("
+                          << table.name[last_alive] << ") WINS! =====\n";
+            else if (live)
+                std::cout << "\n===== NOBODY SURVIVED =====\n";
+            return {last_alive, round + 1};
+        }
+
+        //
+        // ================= STALEMATE CHECK =================
+        //
+        if (stalemate.enabled())
+        {
+            for (int i = 0; i < count; i++)
+                stalemate.update(i, table.row[i], table.col[i], table.health[i], table.armor[i]);
+
+            if (stalemate.end_round())
+            {
+                events.emit(EVENT_DRAW, -1, -1, DRAW_STALEMATE, 0, 0, round + 1);
+                spectate(round + 1, grid, table, opts, true);
+                if (live)
+                    std::cout << "\n===== DRAW: stalemate after " << round + 1 << " rounds =====\n";
+                return {-1, round + 1, true};
+            }
+        }
+    }
+
+    events.emit(EVENT_DRAW, -1, -1, DRAW_ROUND_LIMIT, 0, 0, opts.max_rounds);
+    spectate(opts.max_rounds, grid, table, opts, true);
+    if (live)
+        std::cout << "\n===== DRAW after " << opts.max_rounds << " rounds =====\n";
+    return {-1, opts.max_rounds};
+}
+
+MatchResult run_match(std::vector<RobotBase *> &robots, Rng &rng, const MatchOptions &opts)
+{
+    if (opts.rows == 10 && opts.cols == 10)
+        return run_match_on<OccupancyGrid>(SmallBoard(), robots, rng, opts);
+    if (opts.rows == 20 && opts.cols == 20)
+        return run_match_on<OccupancyGrid>(StandardBoard(), robots, rng, opts);
+    if (opts.rows == 64 && opts.cols == 64)
+        return run_match_on<OccupancyGrid>(LargeBoard(), robots, rng, opts);
+    if (is_sparse_board(opts.rows, opts.cols))
+        return run_match_on<SparseGrid>(DynamicBoard{opts.rows, opts.cols}, robots, rng, opts);
+    return run_match_on<OccupancyGrid>(DynamicBoard{opts.rows, opts.cols}, robots, rng, opts);
+}
+
+MatchResult resume_match(const ArenaState &state, std::vector<RobotBase *> &robots, Rng &rng,
+                         const MatchOptions &opts)
+{
+    int rows = state.grid.rows();
+    int cols = state.grid.cols();
+
+    if (rows == 10 && cols == 10)
+        return run_match_on<OccupancyGrid>(SmallBoard(), robots, rng, opts, &state);
+    if (rows == 20 && cols == 20)
+        return run_match_on<OccupancyGrid>(StandardBoard(), robots, rng, opts, &state);
+    if (rows == 64 && cols == 64)
+        return run_match_on<OccupancyGrid>(LargeBoard(), robots, rng, opts, &state);
+    return run_match_on<OccupancyGrid>(DynamicBoard{rows, cols}, robots, rng, opts, &state);
+}
+
+MatchResult play_match(const std::vector<const RobotLibrary *> &libs, uint64_t seed,
+                       const MatchOptions &opts)
+{
+    Rng rng(seed);
+    int count = static_cast<int>(libs.size());
+
+    // the robots' streams are split off first, so however many numbers a
+    // robot draws it can't shift the arena's own rolls. they are shared
+    // with the watchdog: a robot it leaves stuck in a call may still draw
+    // from its stream after this returns.
+    MatchOptions labelled = opts;
+    labelled.seed = seed;
+    labelled.robot_rngs.clear();
+    for (int i = 0; i < count; i++)
+        labelled.robot_rngs.push_back(std::make_shared<Rng>(rng.split()));
+
+    std::vector<RobotBase *> robots(count);
+    for (int i = 0; i < count; i++)
+    {
+        Rng *robot_rng = labelled.robot_rngs[i].get();
+        if (opts.sandbox)
+        {
+            robots[i] = SandboxedRobot::spawn(*libs[i], robot_rng);
+            continue;
+        }
+        robots[i] = libs[i]->create();
+        if (libs[i]->attach_rng)
+            libs[i]->attach_rng(robots[i], robot_rng);
+    }
+
+    if (opts.profiler || opts.turn_budget_ms > 0 || opts.sandbox)
+    {
+        // "./Robot_Toland.so" -> "Robot_Toland"
+        for (const auto *lib : libs)
+            labelled.robot_names.push_back(std::filesystem::path(lib->path).stem().string());
+    }
+    MatchResult result = run_match(robots, rng, labelled);
+
+    for (auto robot : robots)
+        delete robot;
+    return result;
+}
+
+MatchResult play_match(const RobotLibrary &a, const RobotLibrary &b, uint64_t seed,
+                       const MatchOptions &opts)
+{
+    return play_match(std::vector<const RobotLibrary *>{&a, &b}, seed, opts);
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "RobotBase.h"
+#include "RobotLoader.h"
+#include "Rng.h"
+#include "OccupancyGrid.h"
+#include "SparseGrid.h"
+#include "Spectator.h"
+#include "Profiler.h"
+#include "EventLog.h"
+#include "Stalemate.h"
+
+//
+// =========================================================
+//  ARENA CONSTANTS
+// =========================================================
+//
+
+// default board; --board picks another size
+static const int BOARD_ROWS = 20;
+static const int BOARD_COLS = 20;
+
+// smallest board the spec allows, and the largest a replay can store
+static const int MIN_BOARD_SIZE = 10;
+static const int MAX_BOARD_SIZE = 32767;
+
+// boards with more cells than this are stored as SparseGrid tiles
+static const long long SPARSE_MIN_CELLS = 1024 * 1024;
+
+inline bool is_sparse_board(int rows, int cols)
+{
+    return static_cast<long long>(rows) * cols > SPARSE_MIN_CELLS;
+}
+
+// a match that reaches this many rounds is called a draw, so that a pair
+// of robots that never find each other can't hang a worker thread.
+// --max-rounds changes it.
+static const int MAX_ROUNDS = 10000;
+
+// a match whose robots, health and armor come back to the same state this
+// many times without anyone being hit is called a draw early (Stalemate.h).
+// --stalemate changes it; 0 turns it off.
+static const int STALEMATE_REPEATS = 20;
+
+// with a --turn-budget, a robot that takes longer than that to answer a
+// call forfeits it, and is disqualified after this many (Watchdog.h).
+// --overruns changes it; 0 never disqualifies.
+static const int MAX_OVERRUNS = 3;
+
+// outcome of one match: winner is the index of the last robot standing,
+// or -1 for a draw (round limit, stalemate, or nobody left alive)
+struct MatchResult
+{
+    int winner;
+    int rounds;
+    bool stalemate = false;
+};
+
+// MatchResult::winner of a match stopped at MatchOptions::pause_round
+static const int MATCH_PAUSED = -2;
+
+// one robot as the arena sees it
+struct RobotState
+{
+    int row;
+    int col;
+    bool alive;
+    char glyph;
+    int health;
+    int armor;
+    int grenades;
+    int move;       // 0 once a pit has it
+};
+
+// everything the arena itself knows about a match in progress, by value,
+// so copying it forks the match. what the robots remember is not in here:
+// a fork also needs a copy of every robot (RobotLibrary::clone), and their
+// health and armor travel with those copies. only boards stored as an
+// OccupancyGrid can be paused; tiled ones are too big to copy every time.
+struct ArenaState
+{
+    int round = 0;                     // the next round to play
+    OccupancyGrid grid{0, 0};
+    std::vector<RobotState> robots;
+    std::vector<RadarObj> obstacles;   // as first placed
+    Rng rng;                           // the arena's own stream at the pause
+    StalemateDetector stalemate{0, 0, 0};   // the states seen since the last hit
+};
+
+// how a match is shown. with nothing set the match runs silently at
+// simulation speed instead of terminal speed.
+struct MatchOptions
+{
+    bool live = false;                       // print the board and every event as text
+    Spectator *spectator = nullptr;          // hand frames to a render thread instead of printing
+    double rounds_per_sec = 0;               // play no faster than this; 0 = flat out
+    std::string record_path;                 // write a .rwz replay here if set
+    uint64_t seed = 0;                       // stored in the replay; play_match fills it in
+    int rows = BOARD_ROWS;
+    int cols = BOARD_COLS;
+    int obstacles = -1;                      // scattered at random; -1 = one per 80 cells
+    int max_rounds = MAX_ROUNDS;
+    int stalemate_repeats = STALEMATE_REPEATS;
+    bool sandbox = false;                    // play_match hosts each robot in a child process (Sandbox.h)
+    double turn_budget_ms = 0;               // per robot call; 0 = wait as long as it takes
+    int max_overruns = MAX_OVERRUNS;
+    CallProfiler *profiler = nullptr;        // time every call into the robots if set
+    EventLog *events = nullptr;              // push every round, shot, hit, move and death here if set
+    std::vector<std::string> robot_names;    // for the profiler and watchdog; play_match fills them in
+    std::vector<std::shared_ptr<Rng>> robot_rngs;   // the robots' streams, kept alive by a robot left stuck
+                                                    // in a call; play_match fills them in
+    int pause_round = -1;                    // with paused set, stop before this round...
+    ArenaState *paused = nullptr;            // ...copy the match here and return MATCH_PAUSED
+};
+
+// how many obstacles a board gets for the given --obstacles setting
+int obstacle_count(int rows, int cols, int obstacles);
+
+// the scrolling text board shown in live mode. a tiled board only gets a
+// one-line summary; it is far too big to print.
+void print_arena(int round, const OccupancyGrid &grid);
+void print_arena(int round, const SparseGrid &grid);
+
+// free-for-all between any number of robots (up to MAX_ROBOTS) until at
+// most one is left. obstacles and robots are placed on random empty cells
+// and robots act in vector order. 10x10, 20x20 and 64x64 boards run a core
+// specialized for that size; other sizes run the generic one, on a
+// SparseGrid once the board is over SPARSE_MIN_CELLS. robots must be
+// fresh; a match owns their position and health. every random roll the
+// arena makes comes from rng. a robot the watchdog leaves stuck in a call
+// is now owned by its thread, and its slot in robots is set to null.
+MatchResult run_match(std::vector<RobotBase *> &robots, Rng &rng, const MatchOptions &opts);
+
+// carries on a paused match from where state left it. robots must be
+// copies of the robots that were playing, in the same order, and every
+// random roll comes from rng: a copy of state.rng plays on exactly as the
+// paused match would have, any other stream plays a different future. the
+// stalemate count carries on from the pause too, with the paused match's
+// --stalemate setting. a resumed match is never recorded and can't be
+// paused again.
+MatchResult resume_match(const ArenaState &state, std::vector<RobotBase *> &robots, Rng &rng,
+                         const MatchOptions &opts);
+
+// creates one fresh robot per library entry (entries may repeat), gives
+// each a random stream split off the match seed, plays them and deletes
+// them. the same seed always replays the same match, sandboxed or not.
+MatchResult play_match(const std::vector<const RobotLibrary *> &libs, uint64_t seed,
+                       const MatchOptions &opts);
+
+// the common one-on-one case
+MatchResult play_match(const RobotLibrary &a, const RobotLibrary &b, uint64_t seed,
+                       const MatchOptions &opts);
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// bounded multi-producer, single-consumer queue of fixed-size slots, for
+// threads of one process.
+//
+// every slot carries a sequence number that says whose turn it is: a
+// producer may fill slot i when its sequence equals the count it claimed,
+// and the consumer may read it once the producer has bumped it by one.
+// producers claim counts with a compare-and-swap on head; the consumer
+// alone owns tail. nobody ever waits: a push into a full queue and a pop
+// from an empty one just return false, and the caller decides what to do.
+template <class Slot, uint32_t Capacity>
+class MpscQueue
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "queue capacity must be a power of two");
+
+private:
+    struct Cell
+    {
+        std::atomic<uint64_t> sequence;
+        Slot slot;
+    };
+
+    alignas(64) std::atomic<uint64_t> m_head{0};
+    alignas(64) uint64_t m_tail = 0;
+    std::unique_ptr<Cell[]> m_cells{new Cell[Capacity]};
+
+public:
+    MpscQueue()
+    {
+        for (uint32_t i = 0; i < Capacity; i++)
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+    // any thread. false if the queue is full. place, if given, gets how
+    // many pushes came before this one.
+    bool try_push(const Slot &slot, uint64_t *place = nullptr)
+    {
+        uint64_t head = m_head.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Cell &cell = m_cells[head % Capacity];
+            uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+            int64_t lag = static_cast<int64_t>(sequence - head);
+
+            if (lag == 0)
+            {
+                // our turn at this slot, if no other producer claims it first
+                if (m_head.compare_exchange_weak(head, head + 1, std::memory_order_relaxed))
+                {
+                    cell.slot = slot;
+                    cell.sequence.store(head + 1, std::memory_order_release);
+                    if (place)
+                        *place = head;
+                    return true;
+                }
+            }
+            else if (lag < 0)
+                return false;   // the consumer hasn't got this far round yet
+            else
+                head = m_head.load(std::memory_order_relaxed);
+        }
+    }
+
+    // the consumer thread only. false if the next slot isn't filled yet.
+    bool try_pop(Slot &slot)
+    {
+        Cell &cell = m_cells[m_tail % Capacity];
+        if (cell.sequence.load(std::memory_order_acquire) != m_tail + 1)
+            return false;
+
+        slot = cell.slot;
+        cell.sequence.store(m_tail + Capacity, std::memory_order_release);
+        m_tail++;
+        return true;
+    }
+
+    // the consumer thread only. how many pops have succeeded.
+    uint64_t popped() const { return m_tail; }
+};
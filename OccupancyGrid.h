@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Packed arena occupancy: one byte per cell, row-major.
+//
+// A cell holds either CELL_EMPTY, one of the RadarObj obstacle characters
+// ('M', 'P', 'F', or 'X' for a dead robot), or CELL_ROBOT + index for a live
+// robot. Obstacle characters are all below 0x80, so the high bit alone tells
+// a robot apart from everything else.
+//
+// Alongside the bytes the grid keeps a bitboard with one bit per cell (same
+// row-major index) that is set whenever the cell isn't empty, for the radar.
+constexpr uint8_t CELL_EMPTY = 0;
+constexpr uint8_t CELL_ROBOT = 0x80;
+constexpr int MAX_ROBOTS = 0x80;
+
+class OccupancyGrid
+{
+private:
+    int m_rows;
+    int m_cols;
+
+    // obstacles only - lets a robot leaving a flamethrower cell put it back
+    std::vector<uint8_t> m_terrain;
+    // what radar, rendering and movement see
+    std::vector<uint8_t> m_cells;
+    // bit i set <=> m_cells[i] != CELL_EMPTY
+    std::vector<uint64_t> m_occupied;
+
+    void set_cell(int index, uint8_t cell)
+    {
+        m_cells[index] = cell;
+        uint64_t bit = uint64_t(1) << (index & 63);
+        if (cell != CELL_EMPTY)
+            m_occupied[index >> 6] |= bit;
+        else
+            m_occupied[index >> 6] &= ~bit;
+    }
+
+public:
+    OccupancyGrid(int rows, int cols)
+        : m_rows(rows), m_cols(cols),
+          m_terrain(rows * cols, CELL_EMPTY), m_cells(rows * cols, CELL_EMPTY),
+          m_occupied((rows * cols + 63) / 64, 0) {}
+
+    int rows() const { return m_rows; }
+    int cols() const { return m_cols; }
+
+    bool in_bounds(int row, int col) const
+    {
+        return row >= 0 && col >= 0 && row < m_rows && col < m_cols;
+    }
+
+    uint8_t at(int row, int col) const { return m_cells[row * m_cols + col]; }
+    uint8_t at_index(int index) const { return m_cells[index]; }
+
+    const uint64_t *occupied_words() const { return m_occupied.data(); }
+
+    static bool is_robot(uint8_t cell) { return cell >= CELL_ROBOT; }
+    static int robot_index(uint8_t cell) { return cell - CELL_ROBOT; }
+
+    // the character a radar reports for this cell
+    static char radar_type(uint8_t cell) { return is_robot(cell) ? 'R' : static_cast<char>(cell); }
+
+    // the character a robot is drawn with. letters that look like obstacles
+    // are skipped; past the end of the table glyphs repeat.
+    static char robot_glyph(int index)
+    {
+        static const char glyphs[] = "ABCDEGHIJKLNOQSTUVWYZabcdefghijklmnopqrstuvwxyz0123456789@#$%&*+=?!~^";
+        return glyphs[index % (sizeof(glyphs) - 1)];
+    }
+
+    // what the board shows for a cell
+    static char display_char(uint8_t cell)
+    {
+        if (is_robot(cell))
+            return robot_glyph(robot_index(cell));
+        return cell == CELL_EMPTY ? '.' : static_cast<char>(cell);
+    }
+
+    void place_obstacle(char type, int row, int col)
+    {
+        m_terrain[row * m_cols + col] = static_cast<uint8_t>(type);
+        set_cell(row * m_cols + col, static_cast<uint8_t>(type));
+    }
+
+    void place_robot(int index, int row, int col)
+    {
+        set_cell(row * m_cols + col, static_cast<uint8_t>(CELL_ROBOT + index));
+    }
+
+    // lift a robot off its cell, uncovering whatever terrain was underneath
+    void remove_robot(int row, int col)
+    {
+        set_cell(row * m_cols + col, m_terrain[row * m_cols + col]);
+    }
+
+    void move_robot(int index, int from_row, int from_col, int to_row, int to_col)
+    {
+        remove_robot(from_row, from_col);
+        place_robot(index, to_row, to_col);
+    }
+
+    // a dead robot stays where it fell and blocks the cell like a mound
+    void kill_robot(int row, int col)
+    {
+        set_cell(row * m_cols + col, 'X');
+    }
+};
@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include "Profiler.h"
+
+const char *callback_name(RobotCallback which)
+{
+    switch (which)
+    {
+        case CALL_RADAR_DIRECTION: return "get_radar_direction";
+        case CALL_PROCESS_RADAR:   return "process_radar_results";
+        case CALL_SHOT_LOCATION:   return "get_shot_location";
+        case CALL_MOVE_DIRECTION:  return "get_move_direction";
+        default:                   return "?";
+    }
+}
+
+//
+// =========================================================
+//  HISTOGRAM
+// =========================================================
+//
+
+int LatencyHistogram::bucket_of(uint64_t ns)
+{
+    ns = std::min(ns, (uint64_t(1) << MAX_BITS) - 1);
+    if (ns < 2 * SUB_COUNT)
+        return static_cast<int>(ns);
+
+    // keep the top SUB_BITS + 1 bits; the shift picks the power of two
+    int shift = std::bit_width(ns) - (SUB_BITS + 1);
+    return shift * SUB_COUNT + static_cast<int>(ns >> shift);
+}
+
+uint64_t LatencyHistogram::bucket_top(int bucket)
+{
+    if (bucket < 2 * SUB_COUNT)
+        return bucket;
+
+    int shift = bucket / SUB_COUNT - 1;
+    uint64_t low = static_cast<uint64_t>(bucket - shift * SUB_COUNT) << shift;
+    return low + (uint64_t(1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t ns)
+{
+    m_counts[bucket_of(ns)]++;
+    m_total++;
+    m_sum += ns;
+    m_max = std::max(m_max, ns);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    for (int i = 0; i < BUCKETS; i++)
+        m_counts[i] += other.m_counts[i];
+    m_total += other.m_total;
+    m_sum += other.m_sum;
+    m_max = std::max(m_max, other.m_max);
+}
+
+uint64_t LatencyHistogram::percentile(double fraction) const
+{
+    if (m_total == 0)
+        return 0;
+
+    uint64_t wanted = std::max<uint64_t>(1, static_cast<uint64_t>(fraction * m_total + 0.5));
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; i++)
+    {
+        seen += m_counts[i];
+        if (seen >= wanted)
+            return std::min(bucket_top(i), m_max);
+    }
+    return m_max;
+}
+
+uint64_t RobotProfile::total_ns() const
+{
+    uint64_t total = 0;
+    for (const auto &hist : calls)
+        total += hist.sum();
+    return total;
+}
+
+//
+// =========================================================
+//  PROFILER
+// =========================================================
+//
+
+void CallProfiler::merge(const std::vector<RobotProfile> &robots)
+{
+    std::lock_guard<std::mutex> hold(m_lock);
+
+    for (const auto &robot : robots)
+    {
+        auto it = std::find_if(m_robots.begin(), m_robots.end(),
+                               [&](const RobotProfile &p) { return p.name == robot.name; });
+        if (it == m_robots.end())
+        {
+            m_robots.push_back(robot);
+            continue;
+        }
+        for (int c = 0; c < CALLBACK_COUNT; c++)
+            it->calls[c].merge(robot.calls[c]);
+    }
+}
+
+void CallProfiler::print(std::ostream &out) const
+{
+    std::lock_guard<std::mutex> hold(m_lock);
+
+    std::vector<const RobotProfile *> order;
+    for (const auto &robot : m_robots)
+        order.push_back(&robot);
+    std::sort(order.begin(), order.end(), [](const RobotProfile *a, const RobotProfile *b)
+    {
+        return a->total_ns() > b->total_ns();
+    });
+
+    size_t width = 5;
+    for (const auto *robot : order)
+        width = std::max(width, robot->name.size());
+    width += 2;
+
+    auto us = [](uint64_t ns) { return ns / 1000.0; };
+
+    out << "\n===== ROBOT CALL LATENCY (microseconds) =====\n"
+        << std::left << std::setw(width) << "robot" << std::setw(24) << "callback" << std::right
+        << std::setw(10) << "calls" << std::setw(10) << "mean" << std::setw(10) << "p50"
+        << std::setw(10) << "p99" << std::setw(12) << "max" << std::setw(12) << "total ms" << "\n";
+
+    out << std::fixed << std::setprecision(2);
+    for (const auto *robot : order)
+    {
+        for (int c = 0; c < CALLBACK_COUNT; c++)
+        {
+            const LatencyHistogram &hist = robot->calls[c];
+            out << std::left << std::setw(width) << robot->name
+                << std::setw(24) << callback_name(static_cast<RobotCallback>(c)) << std::right
+                << std::setw(10) << hist.count() << std::setw(10) << us(hist.mean())
+                << std::setw(10) << us(hist.percentile(0.5)) << std::setw(10) << us(hist.percentile(0.99))
+                << std::setw(12) << us(hist.max()) << std::setw(12) << hist.sum() / 1e6 << "\n";
+        }
+    }
+    out << std::defaultfloat;
+}
+
+bool CallProfiler::write_csv(const std::string &path) const
+{
+    std::ofstream out(path);
+    if (!out)
+    {
+        std::cerr << "ERROR: can't write profile file " << path << "\n";
+        return false;
+    }
+
+    std::lock_guard<std::mutex> hold(m_lock);
+
+    out << "robot,callback,calls,total_ns,mean_ns,p50_ns,p99_ns,max_ns\n";
+    for (const auto &robot : m_robots)
+    {
+        for (int c = 0; c < CALLBACK_COUNT; c++)
+        {
+            const LatencyHistogram &hist = robot.calls[c];
+            out << robot.name << "," << callback_name(static_cast<RobotCallback>(c)) << ","
+                << hist.count() << "," << hist.sum() << "," << hist.mean() << ","
+                << hist.percentile(0.5) << "," << hist.percentile(0.99) << "," << hist.max() << "\n";
+        }
+    }
+    return static_cast<bool>(out);
+}
+
+//
+// =========================================================
+//  MATCH PROFILE
+// =========================================================
+//
+
+MatchProfile::MatchProfile(CallProfiler *profiler, const std::vector<std::string> &names)
+    : m_profiler(profiler)
+{
+    if (!m_profiler)
+        return;
+
+    m_robots.resize(names.size());
+    for (size_t i = 0; i < names.size(); i++)
+        m_robots[i].name = names[i];
+}
+
+MatchProfile::~MatchProfile()
+{
+    if (m_profiler)
+        m_profiler->merge(m_robots);
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// the four calls the arena makes into a robot every round
+enum RobotCallback
+{
+    CALL_RADAR_DIRECTION,
+    CALL_PROCESS_RADAR,
+    CALL_SHOT_LOCATION,
+    CALL_MOVE_DIRECTION,
+    CALLBACK_COUNT
+};
+
+const char *callback_name(RobotCallback which);
+
+// HDR-style latency histogram in nanoseconds. values below 64 get a bucket
+// each; above that every power of two is split into 32 buckets, so any
+// percentile read back is within about 3% of the true value. recording is
+// a shift and an increment.
+class LatencyHistogram
+{
+private:
+    static const int SUB_BITS = 5;
+    static const int SUB_COUNT = 1 << SUB_BITS;
+    static const int MAX_BITS = 42;   // ~73 minutes; longer calls are clamped
+    static const int BUCKETS = (MAX_BITS - SUB_BITS + 1) * SUB_COUNT;
+
+    std::array<uint64_t, BUCKETS> m_counts{};
+    uint64_t m_total = 0;
+    uint64_t m_sum = 0;
+    uint64_t m_max = 0;
+
+    static int bucket_of(uint64_t ns);
+    static uint64_t bucket_top(int bucket);
+
+public:
+    void record(uint64_t ns);
+    void merge(const LatencyHistogram &other);
+
+    uint64_t count() const { return m_total; }
+    uint64_t sum() const { return m_sum; }
+    uint64_t max() const { return m_max; }
+    uint64_t mean() const { return m_total ? m_sum / m_total : 0; }
+
+    // the smallest bucket value that at least fraction of the calls fall
+    // under (0.5 = median). 0 when nothing was recorded.
+    uint64_t percentile(double fraction) const;
+};
+
+// timings for every callback of one robot
+struct RobotProfile
+{
+    std::string name;
+    LatencyHistogram calls[CALLBACK_COUNT];
+
+    uint64_t total_ns() const;
+};
+
+// per-robot callback timings gathered over any number of matches, which
+// may run on different threads. each match times into its own MatchProfile
+// and folds it in here once, when it ends; robots with the same name share
+// a row.
+class CallProfiler
+{
+private:
+    mutable std::mutex m_lock;
+    std::vector<RobotProfile> m_robots;   // in the order first seen
+
+public:
+    void merge(const std::vector<RobotProfile> &robots);
+
+    // p50/p99/max per robot and callback, slowest robot first
+    void print(std::ostream &out) const;
+
+    // the same numbers, one robot and callback per line, in nanoseconds.
+    // returns false if the file can't be written.
+    bool write_csv(const std::string &path) const;
+};
+
+// the timings of one match. with no profiler it records nothing and time()
+// just makes the call.
+class MatchProfile
+{
+private:
+    CallProfiler *m_profiler;
+    std::vector<RobotProfile> m_robots;
+
+public:
+    MatchProfile(CallProfiler *profiler, const std::vector<std::string> &names);
+    ~MatchProfile();
+
+    MatchProfile(const MatchProfile &) = delete;
+    MatchProfile &operator=(const MatchProfile &) = delete;
+
+    template <class Call>
+    void time(int robot, RobotCallback which, Call &&call)
+    {
+        if (!m_profiler)
+        {
+            call();
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        call();
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        m_robots[robot].calls[which].record(static_cast<uint64_t>(ns));
+    }
+};
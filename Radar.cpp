@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include "Radar.h"
+
+//
+// =========================================================
+//  MASK TABLES
+// =========================================================
+//
+
+RadarMasks::RadarMasks(int rows, int cols)
+    : m_rows(rows), m_cols(cols), m_spans(static_cast<size_t>(rows) * cols * 9)
+{
+    std::vector<int> bits;
+
+    for (int r = 0; r < rows; r++)
+    {
+        for (int c = 0; c < cols; c++)
+        {
+            for (int dir = 0; dir <= 8; dir++)
+            {
+                bits.clear();
+                for_each_radar_cell(rows, cols, r, c, dir, [&](int rr, int cc)
+                {
+                    bits.push_back(rr * cols + cc);
+                });
+
+                Span &span = m_spans[(r * cols + c) * 9 + dir];
+                span.offset = static_cast<uint32_t>(m_words.size());
+                if (bits.empty())
+                {
+                    span.first = 0;
+                    span.count = 0;
+                    continue;
+                }
+
+                auto [lo, hi] = std::minmax_element(bits.begin(), bits.end());
+                span.first = static_cast<uint16_t>(*lo / 64);
+                span.count = static_cast<uint16_t>(*hi / 64 - *lo / 64 + 1);
+
+                m_words.resize(m_words.size() + span.count, 0);
+                for (int bit : bits)
+                    m_words[span.offset + bit / 64 - span.first] |= uint64_t(1) << (bit % 64);
+            }
+        }
+    }
+}
+
+// the hot path: AND the mask into the occupancy bitboard a word at a time
+// and pull the hits out with count-trailing-zeros
+void RadarMasks::scan(const OccupancyGrid &grid, int row, int col, int direction,
+                      std::vector<RadarObj> &results) const
+{
+    if (direction < 0 || direction > 8)
+        return;
+
+    const Span &span = m_spans[(row * m_cols + col) * 9 + direction];
+    const uint64_t *occupied = grid.occupied_words() + span.first;
+    const uint64_t *mask = m_words.data() + span.offset;
+
+    int found = 0;
+    for (int i = 0; i < span.count; i++)
+        found += std::popcount(occupied[i] & mask[i]);
+    results.reserve(results.size() + found);
+
+    for (int i = 0; i < span.count; i++)
+    {
+        uint64_t hits = occupied[i] & mask[i];
+        int base = (span.first + i) * 64;
+        while (hits)
+        {
+            int index = base + std::countr_zero(hits);
+            results.push_back(RadarObj(OccupancyGrid::radar_type(grid.at_index(index)),
+                                       index / m_cols, index % m_cols));
+            hits &= hits - 1;
+        }
+    }
+}
+
+const RadarMasks *RadarMasks::for_board(int rows, int cols)
+{
+    if (rows * cols > MAX_CELLS)
+        return nullptr;
+
+    static std::mutex lock;
+    static std::map<std::pair<int, int>, std::unique_ptr<RadarMasks>> tables;
+
+    std::lock_guard<std::mutex> guard(lock);
+    auto &table = tables[{rows, cols}];
+    if (!table)
+        table = std::make_unique<RadarMasks>(rows, cols);
+    return table.get();
+}
+
+//
+// =========================================================
+//  RADAR SCAN FUNCTION
+// =========================================================
+//
+
+// walks find cells in ray order; reports go out in the bitboard's order
+static void sort_row_major(std::vector<RadarObj> &results)
+{
+    std::sort(results.begin(), results.end(), [](const RadarObj &a, const RadarObj &b)
+    {
+        return a.m_row != b.m_row ? a.m_row < b.m_row : a.m_col < b.m_col;
+    });
+}
+
+void perform_radar_scan(const OccupancyGrid &grid, const RadarMasks *masks,
+                        int row, int col, int direction, std::vector<RadarObj> &results)
+{
+    results.clear();
+
+    if (masks)
+    {
+        masks->scan(grid, row, col, direction, results);
+        return;
+    }
+
+    // big boards: walk the area, then match the bitboard's row-major order
+    for_each_radar_cell(grid.rows(), grid.cols(), row, col, direction, [&](int r, int c)
+    {
+        uint8_t cell = grid.at(r, c);
+        if (cell != CELL_EMPTY)
+            results.push_back(RadarObj(OccupancyGrid::radar_type(cell), r, c));
+    });
+
+    sort_row_major(results);
+}
+
+// steps along (dr, dc) from (row, col) until the tile changes
+static int steps_to_leave_tile(int row, int col, int dr, int dc)
+{
+    const int mask = SparseGrid::TILE_MASK;
+    int steps = INT_MAX;
+    if (dr > 0) steps = std::min(steps, mask - (row & mask) + 1);
+    if (dr < 0) steps = std::min(steps, (row & mask) + 1);
+    if (dc > 0) steps = std::min(steps, mask - (col & mask) + 1);
+    if (dc < 0) steps = std::min(steps, (col & mask) + 1);
+    return steps;
+}
+
+void perform_radar_scan(const SparseGrid &grid, int row, int col, int direction,
+                        std::vector<RadarObj> &results)
+{
+    results.clear();
+
+    auto look = [&](int r, int c)
+    {
+        uint8_t cell = grid.at(r, c);
+        if (cell != CELL_EMPTY)
+            results.push_back(RadarObj(OccupancyGrid::radar_type(cell), r, c));
+    };
+
+    if (direction == 0)
+    {
+        for (int d = 1; d <= 8; d++)
+        {
+            int r = row + directions[d].first;
+            int c = col + directions[d].second;
+            if (grid.in_bounds(r, c))
+                look(r, c);
+        }
+        sort_row_major(results);
+        return;
+    }
+    if (direction < 1 || direction > 8)
+        return;
+
+    int dr = directions[direction].first;
+    int dc = directions[direction].second;
+
+    // the band is three parallel lanes; lane i is at (r0 + k*dr, c0 + k*dc)
+    // on step k. a lane that has left the board never comes back.
+    int side1_r, side1_c, side2_r, side2_c;
+    radar_side_offsets(direction, side1_r, side1_c, side2_r, side2_c);
+    const int lanes[3][2] = {{row, col}, {row + side1_r, col + side1_c}, {row + side2_r, col + side2_c}};
+
+    for (int k = 1; ; )
+    {
+        bool on_board = false;
+        bool occupied = false;
+        int next = INT_MAX;
+
+        for (const auto &lane : lanes)
+        {
+            int r = lane[0] + k * dr;
+            int c = lane[1] + k * dc;
+            if (!grid.in_bounds(r, c))
+                continue;
+
+            on_board = true;
+            if (grid.tile_occupied(r, c))
+                occupied = true;
+            else
+                next = std::min(next, k + steps_to_leave_tile(r, c, dr, dc));
+        }
+
+        if (!on_board)
+            break;
+
+        if (!occupied)
+        {
+            // every lane still on the board is crossing an empty tile
+            k = next;
+            continue;
+        }
+
+        for (const auto &lane : lanes)
+        {
+            int r = lane[0] + k * dr;
+            int c = lane[1] + k * dc;
+            if (grid.in_bounds(r, c) && grid.tile_occupied(r, c))
+                look(r, c);
+        }
+        k++;
+    }
+
+    sort_row_major(results);
+}
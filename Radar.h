@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "OccupancyGrid.h"
+#include "SparseGrid.h"
+#include "RadarObj.h"
+#include "RobotBase.h"
+
+// Radar as the spec describes it.
+//
+// Directions 1-8 (see RobotBase.h) look along a ray 3 cells wide from the
+// robot to the edge of the board. For up/down/left/right the ray is the
+// row or column the robot faces plus the one on each side; for diagonals it
+// is the diagonal plus the cells just inside it on either side, so the band
+// has no gaps. Direction 0 looks at the 8 cells around the robot. Every
+// non-empty cell in the area is reported, in row-major order; the robot's
+// own cell never is.
+
+// precomputed radar areas for one board size: for every cell and direction,
+// a mask over the grid's occupancy bitboard. only the span of words a mask
+// actually touches is stored.
+class RadarMasks
+{
+private:
+    int m_rows;
+    int m_cols;
+
+    struct Span
+    {
+        uint32_t offset;    // into m_words
+        uint16_t first;     // first bitboard word covered
+        uint16_t count;     // number of words
+    };
+
+    std::vector<Span> m_spans;       // [cell * 9 + direction]
+    std::vector<uint64_t> m_words;
+
+public:
+    // boards bigger than this walk the ray instead; the tables grow with
+    // cells * ray length and stop paying for themselves
+    static const int MAX_CELLS = 64 * 64;
+
+    RadarMasks(int rows, int cols);
+
+    int rows() const { return m_rows; }
+    int cols() const { return m_cols; }
+
+    // appends what the radar sees from (row, col) in direction to results
+    void scan(const OccupancyGrid &grid, int row, int col, int direction,
+              std::vector<RadarObj> &results) const;
+
+    // shared tables for a board size, built on first use (thread-safe).
+    // null if the board is over MAX_CELLS.
+    static const RadarMasks *for_board(int rows, int cols);
+};
+
+// the two side cells of a ray in direction 1-8, relative to the cell on
+// the ray: across it for straight directions, one step back along each
+// axis for diagonals
+inline void radar_side_offsets(int direction, int &side1_r, int &side1_c, int &side2_r, int &side2_c)
+{
+    int dr = directions[direction].first;
+    int dc = directions[direction].second;
+
+    if (dr == 0 || dc == 0)
+    {
+        side1_r = dc;  side1_c = dr;
+        side2_r = -dc; side2_c = -dr;
+    }
+    else
+    {
+        side1_r = 0;   side1_c = -dc;
+        side2_r = -dr; side2_c = 0;
+    }
+}
+
+// calls fn(row, col) for every in-bounds cell of the radar area, in no
+// particular order. directions outside 0-8 cover nothing.
+template <typename Fn>
+void for_each_radar_cell(int rows, int cols, int row, int col, int direction, Fn fn);
+
+// what the radar at (row, col) sees looking in direction, written over
+// results. uses masks when given (they must match the grid size) and walks
+// the area otherwise. results keeps its capacity, so a buffer reused round
+// after round stops allocating once it has held the largest scan.
+void perform_radar_scan(const OccupancyGrid &grid, const RadarMasks *masks,
+                        int row, int col, int direction, std::vector<RadarObj> &results);
+
+// the same on a tiled board. the ray jumps over empty tiles, so looking
+// across open space costs per tile rather than per cell.
+void perform_radar_scan(const SparseGrid &grid, int row, int col, int direction,
+                        std::vector<RadarObj> &results);
+
+template <typename Fn>
+void for_each_radar_cell(int rows, int cols, int row, int col, int direction, Fn fn)
+{
+    auto visit = [&](int r, int c)
+    {
+        if (r >= 0 && c >= 0 && r < rows && c < cols)
+            fn(r, c);
+    };
+
+    if (direction == 0)
+    {
+        for (int d = 1; d <= 8; d++)
+            visit(row + directions[d].first, col + directions[d].second);
+        return;
+    }
+    if (direction < 1 || direction > 8)
+        return;
+
+    int dr = directions[direction].first;
+    int dc = directions[direction].second;
+
+    int side1_r, side1_c, side2_r, side2_c;
+    radar_side_offsets(direction, side1_r, side1_c, side2_r, side2_c);
+
+    // keep going until all three cells of the band are off the board
+    for (int k = 1; ; k++)
+    {
+        int r = row + k * dr;
+        int c = col + k * dc;
+
+        bool any = false;
+        const int cells[3][2] = {{r, c}, {r + side1_r, c + side1_c}, {r + side2_r, c + side2_c}};
+        for (const auto &cell : cells)
+        {
+            if (cell[0] >= 0 && cell[1] >= 0 && cell[0] < rows && cell[1] < cols)
+            {
+                fn(cell[0], cell[1]);
+                any = true;
+            }
+        }
+        if (!any)
+            break;
+    }
+}
@@ -0,0 +1,214 @@
+#include <iostream>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Replay.h"
+#include "OccupancyGrid.h"
+
+//
+// =========================================================
+//  WRITER
+// =========================================================
+//
+
+ReplayWriter::~ReplayWriter()
+{
+    close();
+}
+
+bool ReplayWriter::open(const std::string &path, const ReplayHeader &header,
+                        const ReplayRobotInfo robots[], const ReplayObstacle obstacles[])
+{
+    close();
+
+    m_file = std::fopen(path.c_str(), "wb");
+    if (!m_file)
+    {
+        std::cerr << "ERROR: can't create replay file " << path << "\n";
+        return false;
+    }
+
+    // one big buffer so a round is a memcpy, not a syscall
+    m_buffer.resize(1 << 16);
+    std::setvbuf(m_file, m_buffer.data(), _IOFBF, m_buffer.size());
+
+    m_robot_count = header.robot_count;
+    std::fwrite(&header, sizeof(header), 1, m_file);
+    std::fwrite(robots, sizeof(ReplayRobotInfo), header.robot_count, m_file);
+    std::fwrite(obstacles, sizeof(ReplayObstacle), header.obstacle_count, m_file);
+    return true;
+}
+
+void ReplayWriter::append(uint32_t round, const ReplayRobot robots[])
+{
+    if (!m_file)
+        return;
+
+    std::fwrite(&round, sizeof(round), 1, m_file);
+    std::fwrite(robots, sizeof(ReplayRobot), m_robot_count, m_file);
+}
+
+void ReplayWriter::close()
+{
+    if (m_file)
+        std::fclose(m_file);
+    m_file = nullptr;
+}
+
+//
+// =========================================================
+//  READER
+// =========================================================
+//
+
+ReplayReader::~ReplayReader()
+{
+    close();
+}
+
+bool ReplayReader::open(const std::string &path)
+{
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        std::cerr << "ERROR: can't open replay file " << path << "\n";
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(ReplayHeader)))
+    {
+        std::cerr << "ERROR: " << path << " is too short to be a replay\n";
+        ::close(fd);
+        return false;
+    }
+
+    void *mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        std::cerr << "ERROR: can't map replay file " << path << "\n";
+        return false;
+    }
+
+    m_data = static_cast<const unsigned char *>(mapped);
+    m_size = info.st_size;
+    std::memcpy(&m_header, m_data, sizeof(m_header));
+
+    if (std::memcmp(m_header.magic, REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) != 0 ||
+        m_header.version != REPLAY_VERSION)
+    {
+        std::cerr << "ERROR: " << path << " is not a version " << REPLAY_VERSION << " replay\n";
+        close();
+        return false;
+    }
+
+    m_data_offset = sizeof(ReplayHeader) +
+                    m_header.robot_count * sizeof(ReplayRobotInfo) +
+                    m_header.obstacle_count * sizeof(ReplayObstacle);
+    m_round_size = sizeof(uint32_t) + m_header.robot_count * sizeof(ReplayRobot);
+
+    if (m_data_offset > m_size)
+    {
+        std::cerr << "ERROR: " << path << " is truncated\n";
+        close();
+        return false;
+    }
+
+    // a torn last record (writer killed mid-round) is ignored
+    m_round_count = (m_size - m_data_offset) / m_round_size;
+
+    if (!records_in_bounds())
+    {
+        std::cerr << "ERROR: " << path << " is corrupt (a position is off its " << m_header.rows << "x"
+                  << m_header.cols << " board)\n";
+        close();
+        return false;
+    }
+    return true;
+}
+
+// whatever the file says is written straight into a grid of the header's
+// size, so every position in it has to be on that board
+bool ReplayReader::records_in_bounds() const
+{
+    auto on_board = [&](int row, int col)
+    {
+        return row >= 0 && col >= 0 && row < m_header.rows && col < m_header.cols;
+    };
+
+    if (m_header.rows < 1 || m_header.cols < 1 || m_header.robot_count > MAX_ROBOTS)
+        return false;
+
+    for (int i = 0; i < m_header.robot_count; i++)
+    {
+        ReplayRobotInfo info = robot_info(i);
+        if (!on_board(info.start_row, info.start_col))
+            return false;
+    }
+
+    for (int i = 0; i < m_header.obstacle_count; i++)
+    {
+        ReplayObstacle ob = obstacle(i);
+        if ((ob.type != 'M' && ob.type != 'P' && ob.type != 'F') || !on_board(ob.row, ob.col))
+            return false;
+    }
+
+    for (size_t round = 0; round < m_round_count; round++)
+    {
+        for (int i = 0; i < m_header.robot_count; i++)
+        {
+            ReplayRobot rec = robot(round, i);
+            if (!on_board(rec.row, rec.col))
+                return false;
+        }
+    }
+    return true;
+}
+
+void ReplayReader::close()
+{
+    if (m_data)
+        munmap(const_cast<unsigned char *>(m_data), m_size);
+    m_data = nullptr;
+    m_size = 0;
+    m_round_count = 0;
+}
+
+// records aren't aligned, so everything is copied out rather than cast
+
+ReplayRobotInfo ReplayReader::robot_info(int robot) const
+{
+    ReplayRobotInfo info;
+    std::memcpy(&info, m_data + sizeof(ReplayHeader) + robot * sizeof(ReplayRobotInfo), sizeof(info));
+    return info;
+}
+
+ReplayObstacle ReplayReader::obstacle(int index) const
+{
+    ReplayObstacle ob;
+    size_t offset = sizeof(ReplayHeader) + m_header.robot_count * sizeof(ReplayRobotInfo) +
+                    index * sizeof(ReplayObstacle);
+    std::memcpy(&ob, m_data + offset, sizeof(ob));
+    return ob;
+}
+
+uint32_t ReplayReader::round_number(size_t round) const
+{
+    uint32_t number;
+    std::memcpy(&number, m_data + m_data_offset + round * m_round_size, sizeof(number));
+    return number;
+}
+
+ReplayRobot ReplayReader::robot(size_t round, int robot) const
+{
+    ReplayRobot rec;
+    size_t offset = m_data_offset + round * m_round_size + sizeof(uint32_t) +
+                    robot * sizeof(ReplayRobot);
+    std::memcpy(&rec, m_data + offset, sizeof(rec));
+    return rec;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Binary match replay (.rwz).
+//
+// Layout, all little-endian and unpadded:
+//
+//     ReplayHeader
+//     ReplayRobotInfo   x robot_count
+//     ReplayObstacle    x obstacle_count
+//     round record      x however many rounds were played
+//
+// A round record is a uint32 round number followed by one ReplayRobot per
+// robot, so every record has the same size and round k starts at
+// data_offset() + k * round_size(). The file is only ever appended to; the
+// number of rounds is worked out from the file size.
+
+static const char REPLAY_MAGIC[4] = {'R', 'W', 'Z', 'R'};
+static const uint16_t REPLAY_VERSION = 1;
+
+#pragma pack(push, 1)
+
+struct ReplayHeader
+{
+    char magic[4];
+    uint16_t version;
+    uint16_t rows;
+    uint16_t cols;
+    uint16_t robot_count;
+    uint16_t obstacle_count;
+    uint64_t seed;
+};
+
+struct ReplayRobotInfo
+{
+    char name[16];        // NUL-padded, may be cut short
+    int16_t start_row;
+    int16_t start_col;
+};
+
+struct ReplayObstacle
+{
+    char type;
+    int16_t row;
+    int16_t col;
+};
+
+// what one robot did in one round and where it ended up
+struct ReplayRobot
+{
+    int8_t radar_dir;     // as returned by get_radar_direction
+    int8_t shot;          // 1 if it fired this round
+    int16_t shot_row;
+    int16_t shot_col;
+    int8_t hits;          // robots its shot hit
+    int16_t damage;       // total damage its shot dealt
+    int8_t move_dir;      // as requested
+    int8_t move_dist;     // as requested
+    int16_t row;          // position at the end of the round
+    int16_t col;
+    int16_t health;       // at the end of the round, 0 = dead
+    int8_t armor;
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(ReplayHeader) == 22, "replay header layout changed");
+static_assert(sizeof(ReplayRobot) == 18, "replay robot record layout changed");
+
+// appends a match to a .rwz file through a large stdio buffer
+class ReplayWriter
+{
+private:
+    std::FILE *m_file = nullptr;
+    int m_robot_count = 0;
+    std::vector<char> m_buffer;
+
+public:
+    ReplayWriter() = default;
+    ~ReplayWriter();
+
+    ReplayWriter(const ReplayWriter &) = delete;
+    ReplayWriter &operator=(const ReplayWriter &) = delete;
+
+    // creates path and writes the header, robot table and obstacles.
+    // prints the reason and returns false on failure.
+    bool open(const std::string &path, const ReplayHeader &header,
+              const ReplayRobotInfo robots[], const ReplayObstacle obstacles[]);
+
+    bool is_open() const { return m_file != nullptr; }
+    int robot_count() const { return m_robot_count; }
+
+    // robots must hold robot_count() records
+    void append(uint32_t round, const ReplayRobot robots[]);
+
+    void close();
+};
+
+// read-only view of a .rwz file mapped into memory. any round can be read
+// directly without touching the ones before it.
+class ReplayReader
+{
+private:
+    const unsigned char *m_data = nullptr;
+    size_t m_size = 0;
+
+    ReplayHeader m_header{};
+    size_t m_data_offset = 0;
+    size_t m_round_size = 0;
+    size_t m_round_count = 0;
+
+    bool records_in_bounds() const;
+
+public:
+    ReplayReader() = default;
+    ~ReplayReader();
+
+    ReplayReader(const ReplayReader &) = delete;
+    ReplayReader &operator=(const ReplayReader &) = delete;
+
+    // maps path and checks the header, and that every obstacle and robot
+    // position is on the board. prints the reason and returns false on
+    // failure.
+    bool open(const std::string &path);
+    void close();
+
+    const ReplayHeader &header() const { return m_header; }
+    size_t round_count() const { return m_round_count; }
+
+    ReplayRobotInfo robot_info(int robot) const;
+    ReplayObstacle obstacle(int index) const;
+
+    uint32_t round_number(size_t round) const;
+    ReplayRobot robot(size_t round, int robot) const;
+};
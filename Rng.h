@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+
+// Small, fast PRNG (xoshiro256**) for match randomness.
+//
+// Every match owns its own Rng seeded from the match seed, so parallel
+// matches never share random state and the same seed replays the same match.
+// Robots can ask for a stream of their own by exporting
+//
+//     extern "C" void attach_rng(RobotBase* robot, Rng* rng);
+//
+// from their .so. The arena calls it right after create_robot() and the
+// pointer stays valid until the robot is deleted.
+class Rng
+{
+private:
+    uint64_t m_state[4];
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    // splitmix64 - spreads nearby seeds (1, 2, 3...) over the whole state
+    static uint64_t splitmix(uint64_t &x)
+    {
+        uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+public:
+    explicit Rng(uint64_t seed = 0)
+    {
+        for (auto &word : m_state)
+            word = splitmix(seed);
+    }
+
+    uint64_t next()
+    {
+        uint64_t result = rotl(m_state[1] * 5, 7) * 9;
+        uint64_t t = m_state[1] << 17;
+
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 45);
+
+        return result;
+    }
+
+    // uniform in [0, n) for n > 0
+    int below(int n)
+    {
+        return static_cast<int>(((next() >> 32) * static_cast<uint64_t>(n)) >> 32);
+    }
+
+    // uniform in [lo, hi], both ends included
+    int range(int lo, int hi) { return lo + below(hi - lo + 1); }
+
+    // a new generator seeded from this one, for handing out independent streams
+    Rng split() { return Rng(next()); }
+};
@@ -0,0 +1,240 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+#include <vector>
+#include "RobotBuild.h"
+#include "WorkStealingPool.h"
+
+namespace fs = std::filesystem;
+
+// the spec's compile command, minus the file names and the include
+// directory, plus -O2: robots that plan their moves (RobotPath.h) spend
+// most of a turn in that code
+static const char ROBOT_CXX[] = "g++ -shared -fPIC -std=c++20 -O2";
+
+// the headers a robot may include; a change to any of them, or to
+// RobotBase.o, rebuilds every robot
+static const char *const ROBOT_HEADERS[] = {"RobotBase.h", "RadarObj.h", "Rng.h", "RobotMap.h", "RobotPath.h"};
+static const char ROBOT_OBJECT[] = "RobotBase.o";
+
+// where the arena's own copies of the robot headers and RobotBase.o are:
+// beside the executable, wherever it is run from
+static fs::path arena_dir()
+{
+    std::error_code err;
+    fs::path exe = fs::read_symlink("/proc/self/exe", err);
+    if (err)
+        return fs::current_path(err);
+    return exe.parent_path();
+}
+
+// the file a robot in dir actually gets for name: a quoted #include looks
+// beside the source first, then in the arena's directory (-I)
+static fs::path robot_header(const fs::path &dir, const fs::path &arena, const char *name)
+{
+    std::error_code err;
+    fs::path local = dir / name;
+    return fs::exists(local, err) ? local : arena / name;
+}
+
+//
+// =========================================================
+//  BUILD KEYS
+// =========================================================
+//
+
+// 64-bit FNV-1a, folded over several inputs
+class BuildHash
+{
+private:
+    uint64_t m_hash = 0xcbf29ce484222325ULL;
+
+public:
+    void add(const char *data, size_t size)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            m_hash ^= static_cast<unsigned char>(data[i]);
+            m_hash *= 0x100000001b3ULL;
+        }
+    }
+
+    void add(const std::string &text)
+    {
+        // the length keeps "ab" + "c" apart from "a" + "bc"
+        uint64_t size = text.size();
+        add(reinterpret_cast<const char *>(&size), sizeof(size));
+        add(text.data(), text.size());
+    }
+
+    // a missing file hashes as empty, so creating it changes the key
+    void add_file(const fs::path &path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::ostringstream contents;
+        contents << in.rdbuf();
+        add(contents.str());
+    }
+
+    std::string hex() const
+    {
+        std::ostringstream out;
+        out << std::hex << std::setw(16) << std::setfill('0') << m_hash;
+        return out.str();
+    }
+};
+
+//
+// =========================================================
+//  ONE ROBOT
+// =========================================================
+//
+
+struct RobotBuild
+{
+    fs::path source;
+    fs::path target;      // Robot_*.so beside the source
+    fs::path cached;      // <cache>/Robot_*-<key>.so
+    fs::path log;
+    bool hit = false;
+    bool ok = false;
+    double seconds = 0;
+};
+
+// puts a copy of from at to, replacing whatever was there in one step, so
+// an arena loading to at the same moment sees the old file or the new one,
+// never half of one. a copy rather than a link, so rebuilding to by hand
+// can't reach into the cache.
+static bool install(const fs::path &from, const fs::path &to, const std::string &tag)
+{
+    fs::path tmp = to;
+    tmp += "." + tag + ".tmp";
+
+    std::error_code err;
+    fs::copy_file(from, tmp, fs::copy_options::overwrite_existing, err);
+    if (!err)
+        fs::rename(tmp, to, err);
+    if (err)
+        fs::remove(tmp, err);
+    return !err;
+}
+
+static void build_robot(RobotBuild &build, const fs::path &arena, const std::string &tag)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    std::error_code err;
+    if (fs::exists(build.cached, err))
+        build.hit = true;
+    else
+    {
+        // compile to a private name and move it into the cache when done
+        fs::path tmp = build.cached;
+        tmp += "." + tag + ".tmp";
+
+        std::string cmd = std::string(ROBOT_CXX) + " -I\"" + arena.string() + "\" -o \"" + tmp.string() +
+                          "\" \"" + build.source.string() + "\" \"" + (arena / ROBOT_OBJECT).string() + "\" > \"" +
+                          build.log.string() + "\" 2>&1";
+        if (std::system(cmd.c_str()) != 0)
+        {
+            fs::remove(tmp, err);
+            return;
+        }
+        fs::rename(tmp, build.cached, err);
+        if (err)
+            return;
+    }
+
+    build.ok = install(build.cached, build.target, tag);
+    build.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+//
+// =========================================================
+//  ALL ROBOTS
+// =========================================================
+//
+
+int compile_robots(const std::string &dir, int threads)
+{
+    std::vector<RobotBuild> builds;
+
+    std::error_code err;
+    for (const auto &entry : fs::directory_iterator(dir, err))
+    {
+        std::string name = entry.path().filename().string();
+        if (entry.is_regular_file() && name.rfind("Robot_", 0) == 0 && entry.path().extension() == ".cpp")
+            builds.push_back({entry.path(), {}, {}, {}});
+    }
+    if (builds.empty())
+        return 0;
+
+    std::sort(builds.begin(), builds.end(),
+              [](const RobotBuild &a, const RobotBuild &b) { return a.source < b.source; });
+
+    fs::path cache = fs::path(dir) / ROBOT_CACHE_DIR;
+    fs::create_directories(cache, err);
+
+    // the shared part of every key: the command and the files that are
+    // really included and linked
+    fs::path arena = arena_dir();
+    BuildHash common;
+    common.add(ROBOT_CXX);
+    for (const char *header : ROBOT_HEADERS)
+        common.add_file(robot_header(dir, arena, header));
+    common.add_file(arena / ROBOT_OBJECT);
+
+    for (auto &build : builds)
+    {
+        BuildHash key = common;
+        key.add_file(build.source);
+
+        std::string stem = build.source.stem().string();
+        build.target = build.source;
+        build.target.replace_extension(".so");
+        build.cached = cache / (stem + "-" + key.hex() + ".so");
+        build.log = cache / (stem + "-" + key.hex() + ".log");
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    WorkStealingPool pool(threads);
+    std::string pid = std::to_string(getpid());
+    pool.run(static_cast<int>(builds.size()), [&](int task)
+    {
+        build_robot(builds[task], arena, pid + "-" + std::to_string(task));
+    });
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    int hits = 0, failed = 0;
+    std::cout << "===== COMPILING " << builds.size() << " robots on " << pool.size() << " threads =====\n"
+              << std::fixed << std::setprecision(2);
+    for (const auto &build : builds)
+    {
+        std::cout << "  " << std::left << std::setw(32) << build.source.filename().string() << std::right;
+        if (!build.ok)
+        {
+            failed++;
+            std::cout << "FAILED, see " << build.log.string() << "\n";
+        }
+        else if (build.hit)
+        {
+            hits++;
+            std::cout << "cached\n";
+        }
+        else
+            std::cout << "compiled in " << build.seconds << "s\n";
+    }
+
+    std::cout << hits << "/" << builds.size() << " cached (" << 100.0 * hits / builds.size() << "%), "
+              << builds.size() - hits - failed << " compiled, " << failed << " failed in "
+              << elapsed.count() << "s\n\n" << std::defaultfloat;
+    return failed;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+
+// where compiled robots are kept, inside the robot directory
+static const char ROBOT_CACHE_DIR[] = ".robotcache";
+
+// compiles every Robot_*.cpp in dir into a Robot_*.so next to it, the way
+// the spec's arena does, but in parallel over threads workers (< 1 = one
+// per hardware thread) and through a cache.
+//
+// robots are compiled against the headers and RobotBase.o beside the arena
+// executable, so this works from any directory. each build is keyed on a
+// hash of the robot's source, the robot headers it would include (its own
+// copy beside it, if there is one), RobotBase.o and the compile command. a
+// robot whose key is already in ROBOT_CACHE_DIR is linked into place
+// without running the compiler. the compiler's output goes to a .log
+// beside the cached .so.
+//
+// prints one line per robot (cached, or compiled and how long it took)
+// and the cache hit rate. returns how many robots failed to compile.
+int compile_robots(const std::string &dir, int threads);
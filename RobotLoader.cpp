@@ -0,0 +1,45 @@
+#include <iostream>
+#include <dlfcn.h>
+#include "RobotLoader.h"
+
+//
+// =========================================================
+//  ROBOT LOADING
+// =========================================================
+//
+
+bool open_robot_library(const char *path, RobotLibrary &lib)
+{
+    lib.path = path;
+    // NODELETE keeps the code mapped after dlclose, for robots the watchdog
+    // had to leave running on a thread of their own
+    lib.handle = dlopen(path, RTLD_LAZY | RTLD_NODELETE);
+    if (!lib.handle)
+    {
+        std::cerr << "dlopen error: " << dlerror() << "\n";
+        return false;
+    }
+
+    lib.create = (RobotFactory)dlsym(lib.handle, "create_robot");
+
+    if (!lib.create)
+    {
+        std::cerr << "ERROR: create_robot() not found in " << path << "\n";
+        close_robot_library(lib);
+        return false;
+    }
+
+    lib.attach_rng = (RngHook)dlsym(lib.handle, "attach_rng");
+    lib.clone = (CloneHook)dlsym(lib.handle, "clone_robot");
+    return true;
+}
+
+void close_robot_library(RobotLibrary &lib)
+{
+    if (lib.handle)
+        dlclose(lib.handle);
+    lib.handle = nullptr;
+    lib.create = nullptr;
+    lib.attach_rng = nullptr;
+    lib.clone = nullptr;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include "RobotBase.h"
+#include "Rng.h"
+
+// optional robot export that hands the robot its own random stream (see Rng.h)
+typedef void (*RngHook)(RobotBase *, Rng *);
+
+// optional robot export that copies a robot mid-match, memory and all:
+//
+//     extern "C" RobotBase* clone_robot(const RobotBase* robot);
+//
+// the copy must not share anything the original can still change. a
+// random stream handed over by attach_rng is handed over again to the copy.
+typedef RobotBase *(*CloneHook)(const RobotBase *);
+
+// a robot .so opened once and kept open. create() builds a fresh,
+// independent robot each time, so every match gets its own instances.
+struct RobotLibrary
+{
+    std::string path;
+    void *handle = nullptr;
+    RobotFactory create = nullptr;
+    RngHook attach_rng = nullptr;   // null if the robot doesn't export one
+    CloneHook clone = nullptr;      // null if the robot can't be copied
+};
+
+// dlopens path and looks up create_robot (and attach_rng and clone_robot if
+// present). prints the reason and returns false on failure.
+bool open_robot_library(const char *path, RobotLibrary &lib);
+void close_robot_library(RobotLibrary &lib);
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "RadarObj.h"
+
+// What a robot remembers of the board, for robots to include. Header only,
+// so a robot .so needs nothing more to link.
+//
+// Obstacles never move, so one radar sighting is enough to remember them
+// for the rest of the match. Each kind is a bit per cell, so recording and
+// asking about a cell are a shift and a mask whatever the robot has seen.
+// Every cell also keeps the turn it was last reported on, and live robots
+// are kept as a short list of recent sightings.
+//
+// The arena sets the board size after the robot is built, so call fit()
+// with m_board_row_max / m_board_col_max before using the map (doing it at
+// the top of process_radar_results is enough):
+//
+//     m_map.fit(m_board_row_max, m_board_col_max);
+//     m_map.observe(radar_results);
+//     ...
+//     if (m_map.is_obstacle(row, col + 1)) ...
+class RobotMap
+{
+public:
+    enum Kind { MOUND, PIT, FLAMETHROWER, WRECK, KIND_COUNT };
+
+    // a cell, as row * cols() + col
+    typedef int Cell;
+
+    // a live robot seen on the radar
+    struct Sighting
+    {
+        int row;
+        int col;
+        uint32_t turn;
+    };
+
+    // sightings older than this many turns are dropped
+    static constexpr uint32_t ROBOT_MEMORY = 16;
+
+private:
+    int m_rows = 0;
+    int m_cols = 0;
+    int m_words_per_kind = 0;
+    uint32_t m_turn = 0;
+
+    std::vector<uint64_t> m_bits;        // [kind * m_words_per_kind + cell / 64]
+    std::vector<uint32_t> m_last_seen;   // [cell], 0 = never
+    std::vector<Sighting> m_robots;      // newest first, at most one per cell
+    std::vector<Sighting> m_kept;        // scratch for observe(), kept to save allocating
+    std::vector<Cell> m_blocked_log;     // cells in the order they stopped being passable
+
+    static int kind_of(char type)
+    {
+        switch (type)
+        {
+            case 'M': return MOUND;
+            case 'P': return PIT;
+            case 'F': return FLAMETHROWER;
+            case 'X': return WRECK;
+            default:  return -1;
+        }
+    }
+
+    int cell(int row, int col) const { return row * m_cols + col; }
+
+    bool bit(int kind, int index) const
+    {
+        return (m_bits[kind * m_words_per_kind + index / 64] >> (index % 64)) & 1;
+    }
+
+    bool blocked(int index) const
+    {
+        for (int kind = 0; kind < KIND_COUNT; kind++)
+        {
+            if (bit(kind, index))
+                return true;
+        }
+        return false;
+    }
+
+public:
+    RobotMap() = default;
+    RobotMap(int rows, int cols) { fit(rows, cols); }
+
+    // sizes the map for a rows x cols board. forgets everything if the
+    // size changed, and does nothing otherwise.
+    void fit(int rows, int cols)
+    {
+        if (rows == m_rows && cols == m_cols)
+            return;
+
+        m_rows = rows > 0 ? rows : 0;
+        m_cols = cols > 0 ? cols : 0;
+        int cells = m_rows * m_cols;
+        m_words_per_kind = (cells + 63) / 64;
+
+        m_bits.assign(static_cast<size_t>(KIND_COUNT) * m_words_per_kind, 0);
+        m_last_seen.assign(cells, 0);
+        m_robots.clear();
+        m_blocked_log.clear();
+        m_turn = 0;
+    }
+
+    int rows() const { return m_rows; }
+    int cols() const { return m_cols; }
+
+    // how many scans have been observed; the first is turn 1
+    uint32_t turn() const { return m_turn; }
+
+    bool on_board(int row, int col) const
+    {
+        return row >= 0 && col >= 0 && row < m_rows && col < m_cols;
+    }
+
+    // starts a new turn and records one radar scan. cells off the board
+    // are ignored.
+    void observe(const std::vector<RadarObj> &results)
+    {
+        m_turn++;
+
+        // this turn's robots go first, in radar order
+        size_t old_count = m_robots.size();
+        for (const auto &obj : results)
+        {
+            if (!on_board(obj.m_row, obj.m_col))
+                continue;
+
+            int index = cell(obj.m_row, obj.m_col);
+            m_last_seen[index] = m_turn;
+
+            int kind = kind_of(obj.m_type);
+            if (kind >= 0)
+            {
+                if (!blocked(index))
+                    m_blocked_log.push_back(index);
+                m_bits[kind * m_words_per_kind + index / 64] |= uint64_t(1) << (index % 64);
+            }
+            else if (obj.m_type == 'R')
+                m_robots.push_back({obj.m_row, obj.m_col, m_turn});
+        }
+
+        // then the older sightings still worth keeping, minus any cell
+        // reported again this turn (it holds a robot or a wreck now)
+        m_kept.assign(m_robots.begin() + old_count, m_robots.end());
+        for (size_t i = 0; i < old_count; i++)
+        {
+            const Sighting &old = m_robots[i];
+            if (m_turn - old.turn < ROBOT_MEMORY && m_last_seen[cell(old.row, old.col)] != m_turn)
+                m_kept.push_back(old);
+        }
+        m_robots.swap(m_kept);
+    }
+
+    // whether a kind of thing has been seen at (row, col). false off the board.
+    bool has(Kind kind, int row, int col) const
+    {
+        return on_board(row, col) && bit(kind, cell(row, col));
+    }
+
+    // a mound, pit or flamethrower has been seen at (row, col)
+    bool is_obstacle(int row, int col) const
+    {
+        if (!on_board(row, col))
+            return false;
+        int index = cell(row, col);
+        return bit(MOUND, index) || bit(PIT, index) || bit(FLAMETHROWER, index);
+    }
+
+    // on the board and nothing known there that stops or hurts a robot
+    // moving in: no obstacle and no wreck
+    bool is_passable(int row, int col) const
+    {
+        return on_board(row, col) && !blocked(cell(row, col));
+    }
+
+    // every cell that has stopped being passable, in the order it was
+    // seen. only ever grows until fit() forgets the board, so a reader
+    // such as RobotPath can keep its place in it.
+    const std::vector<Cell> &blocked_log() const { return m_blocked_log; }
+
+    // the turn (row, col) was last reported by the radar, 0 if never
+    uint32_t last_seen(int row, int col) const
+    {
+        return on_board(row, col) ? m_last_seen[cell(row, col)] : 0;
+    }
+
+    // live robots seen in the last ROBOT_MEMORY turns, newest first; the
+    // ones seen this turn have turn() as their turn
+    const std::vector<Sighting> &robots() const { return m_robots; }
+};
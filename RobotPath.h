@@ -0,0 +1,360 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+#include "RobotBase.h"
+#include "RobotMap.h"
+
+// Shortest paths over a RobotMap, for robots to include. Header only, like
+// RobotMap.
+//
+// This is D* Lite (Koenig and Likhachev): the search runs backwards from
+// the goal, so when the robot moves the search tree stays valid, and when
+// the radar turns up a new obstacle only the cells whose distance it
+// changes are looked at again. Moving toward a fixed goal across a board
+// that is slowly being discovered costs a handful of cell updates a turn
+// rather than a new search.
+//
+// Unknown cells are assumed open. Anything the map says is not passable
+// (mounds, pits, flamethrowers and wrecks) is never stepped into, though a
+// robot already standing on one can leave it. Moves go in any of the 8
+// directions at one cell per step, the way the arena moves robots.
+//
+//     m_path.set_goal(row, col);
+//     if (m_path.next_move(m_map, my_row, my_col, get_move_speed(), direction, distance))
+//         ...
+class RobotPath
+{
+public:
+    static constexpr int UNREACHABLE = 1 << 29;
+
+private:
+    struct Key
+    {
+        int k1;
+        int k2;
+
+        bool operator<(const Key &other) const
+        {
+            return k1 < other.k1 || (k1 == other.k1 && k2 < other.k2);
+        }
+        bool operator==(const Key &other) const { return k1 == other.k1 && k2 == other.k2; }
+    };
+
+    struct Entry
+    {
+        Key key;
+        int cell;
+
+        // std heaps are max-heaps, so order backwards to get the smallest key on top
+        bool operator<(const Entry &other) const { return other.key < key; }
+    };
+
+    int m_rows = 0;
+    int m_cols = 0;
+    int m_goal_row = -1;
+    int m_goal_col = -1;
+    int m_goal = -1;     // the goal's cell, once a search has been started for it
+    int m_start = -1;
+    int m_last = -1;     // where the robot was when km was last brought up to date
+    int m_km = 0;        // how far the key's heuristic has drifted as the robot moved
+    size_t m_log_read = 0;
+    bool m_fresh = true;
+
+    std::vector<int> m_g;
+    std::vector<int> m_rhs;
+    std::vector<Key> m_key;           // key of the live heap entry, if m_open
+    std::vector<uint8_t> m_open;
+    std::vector<uint8_t> m_blocked;   // the map's passability, copied as the blocked log is read
+    std::vector<Entry> m_heap;        // stale entries are skipped when they surface
+
+    const RobotMap *m_map = nullptr;
+
+    int row_of(int cell) const { return cell / m_cols; }
+    int col_of(int cell) const { return cell % m_cols; }
+
+    int heuristic(int a, int b) const
+    {
+        return std::max(std::abs(row_of(a) - row_of(b)), std::abs(col_of(a) - col_of(b)));
+    }
+
+    // whether a step into cell from next door is allowed (it costs 1 if so)
+    bool enterable(int cell) const { return !m_blocked[cell]; }
+
+    static int add(int cost, int g) { return g >= UNREACHABLE ? UNREACHABLE : cost + g; }
+
+    Key key_of(int cell) const
+    {
+        int best = std::min(m_g[cell], m_rhs[cell]);
+        if (best >= UNREACHABLE)
+            return {UNREACHABLE, UNREACHABLE};
+        return {best + heuristic(m_start, cell) + m_km, best};
+    }
+
+    // calls fn(neighbour, direction) for the on-board cells around cell
+    template <typename Fn>
+    void for_each_neighbour(int cell, Fn fn) const
+    {
+        int r = row_of(cell), c = col_of(cell);
+        for (int d = 1; d <= 8; d++)
+        {
+            int nr = r + directions[d].first, nc = c + directions[d].second;
+            if (nr >= 0 && nc >= 0 && nr < m_rows && nc < m_cols)
+                fn(nr * m_cols + nc, d);
+        }
+    }
+
+    void push(int cell)
+    {
+        Key key = key_of(cell);
+        m_key[cell] = key;
+        m_open[cell] = 1;
+        m_heap.push_back({key, cell});
+        std::push_heap(m_heap.begin(), m_heap.end());
+    }
+
+    // drops stale entries off the top; false if nothing live is left
+    bool top(Entry &entry)
+    {
+        while (!m_heap.empty())
+        {
+            entry = m_heap.front();
+            if (m_open[entry.cell] && entry.key == m_key[entry.cell])
+                return true;
+            std::pop_heap(m_heap.begin(), m_heap.end());
+            m_heap.pop_back();
+        }
+        return false;
+    }
+
+    // the best way on from cell, looking at every neighbour
+    int best_rhs(int cell) const
+    {
+        int best = UNREACHABLE;
+        for_each_neighbour(cell, [&](int next, int)
+        {
+            if (enterable(next))
+                best = std::min(best, add(1, m_g[next]));
+        });
+        return best;
+    }
+
+    // queues cell if it is inconsistent and drops it otherwise
+    void update_vertex(int cell)
+    {
+        if (m_g[cell] != m_rhs[cell])
+            push(cell);
+        else
+            m_open[cell] = 0;
+    }
+
+    // the optimised loop from the paper: a cell whose distance drops can
+    // only lower its neighbours' rhs, which is a compare each; only a cell
+    // whose distance rises makes the neighbours that counted on it look
+    // around again
+    void compute_shortest_path()
+    {
+        Entry entry;
+        while (top(entry) && (entry.key < key_of(m_start) || m_rhs[m_start] != m_g[m_start]))
+        {
+            int cell = entry.cell;
+            Key fresh = key_of(cell);
+            std::pop_heap(m_heap.begin(), m_heap.end());
+            m_heap.pop_back();
+
+            if (entry.key < fresh)
+            {
+                // only the heuristic moved; put it back where it belongs
+                push(cell);
+                continue;
+            }
+            m_open[cell] = 0;
+
+            if (m_g[cell] > m_rhs[cell])
+            {
+                m_g[cell] = m_rhs[cell];
+                if (!enterable(cell))
+                    continue;
+
+                int through = m_g[cell] + 1;
+                for_each_neighbour(cell, [&](int prev, int)
+                {
+                    if (prev != m_goal && through < m_rhs[prev])
+                    {
+                        m_rhs[prev] = through;
+                        update_vertex(prev);
+                    }
+                });
+            }
+            else
+            {
+                int through = add(1, m_g[cell]);
+                m_g[cell] = UNREACHABLE;
+                update_vertex(cell);
+
+                if (!enterable(cell))
+                    continue;
+                for_each_neighbour(cell, [&](int prev, int)
+                {
+                    if (prev != m_goal && m_rhs[prev] == through)
+                    {
+                        m_rhs[prev] = best_rhs(prev);
+                        update_vertex(prev);
+                    }
+                });
+            }
+        }
+    }
+
+    void restart()
+    {
+        size_t cells = static_cast<size_t>(m_rows) * m_cols;
+        m_g.assign(cells, UNREACHABLE);
+        m_rhs.assign(cells, UNREACHABLE);
+        m_key.assign(cells, Key{0, 0});
+        m_open.assign(cells, 0);
+        m_blocked.assign(cells, 0);
+        m_heap.clear();
+
+        const std::vector<RobotMap::Cell> &log = m_map->blocked_log();
+        for (RobotMap::Cell cell : log)
+            m_blocked[cell] = 1;
+        m_log_read = log.size();
+
+        m_km = 0;
+        m_last = m_start;
+        m_rhs[m_goal] = 0;
+        push(m_goal);
+        m_fresh = false;
+    }
+
+    // a cell the map has blocked since the last look can't be stepped
+    // into any more, so the neighbours whose best way on went through it
+    // need to look around again
+    void apply_map_changes()
+    {
+        const std::vector<RobotMap::Cell> &log = m_map->blocked_log();
+        if (m_log_read == log.size())
+            return;
+
+        m_km += heuristic(m_last, m_start);
+        m_last = m_start;
+        for (; m_log_read < log.size(); m_log_read++)
+        {
+            int blocked = log[m_log_read];
+            int through = add(1, m_g[blocked]);
+            m_blocked[blocked] = 1;
+
+            for_each_neighbour(blocked, [&](int prev, int)
+            {
+                if (prev != m_goal && m_rhs[prev] == through)
+                {
+                    m_rhs[prev] = best_rhs(prev);
+                    update_vertex(prev);
+                }
+            });
+        }
+    }
+
+public:
+    // where to head for. changing it starts the search over; keeping it
+    // lets every later call repair the last search.
+    void set_goal(int row, int col)
+    {
+        if (row == m_goal_row && col == m_goal_col)
+            return;
+        m_goal_row = row;
+        m_goal_col = col;
+        m_fresh = true;
+    }
+
+    bool has_goal() const { return m_goal_row >= 0; }
+    int goal_row() const { return m_goal_row; }
+    int goal_col() const { return m_goal_col; }
+
+    // forgets the goal; next_move() returns false until there is a new one
+    void clear_goal()
+    {
+        m_goal_row = m_goal_col = -1;
+        m_goal = -1;
+    }
+
+    // brings the search up to date with the robot at (row, col) and what
+    // map knows now, then picks the first leg of the path: a direction and
+    // how far to go along it, 1 to max_distance. stays put (0, 0) at
+    // the goal. false if there is no goal or no known way there.
+    bool next_move(const RobotMap &map, int row, int col, int max_distance, int &direction, int &distance)
+    {
+        direction = 0;
+        distance = 0;
+        if (!has_goal() || !map.on_board(row, col) || !map.on_board(m_goal_row, m_goal_col))
+            return false;
+
+        // a goal the map has blocked can't be reached, and finding that out
+        // by search would mean flooding everything reachable
+        if (!map.is_passable(m_goal_row, m_goal_col) && (m_goal_row != row || m_goal_col != col))
+            return false;
+
+        // a new board (or a new match on the same map object) starts over
+        if (&map != m_map || map.rows() != m_rows || map.cols() != m_cols ||
+            map.blocked_log().size() < m_log_read)
+        {
+            m_map = &map;
+            m_rows = map.rows();
+            m_cols = map.cols();
+            m_fresh = true;
+        }
+
+        m_start = row * m_cols + col;
+        int goal = m_goal_row * m_cols + m_goal_col;
+        if (m_fresh || goal != m_goal)
+        {
+            m_goal = goal;
+            restart();
+        }
+        else
+            apply_map_changes();
+
+        compute_shortest_path();
+        if (m_g[m_start] >= UNREACHABLE)
+            return false;
+        if (m_start == m_goal)
+            return true;
+
+        // of the steps that start a shortest path, take the one that can
+        // keep going straight the longest
+        for_each_neighbour(m_start, [&](int next, int d)
+        {
+            if (!enterable(next) || m_g[next] != m_g[m_start] - 1)
+                return;
+
+            int run = 1;
+            int at = next;
+            while (run < max_distance)
+            {
+                int nr = row_of(at) + directions[d].first, nc = col_of(at) + directions[d].second;
+                if (nr < 0 || nc < 0 || nr >= m_rows || nc >= m_cols)
+                    break;
+                int ahead = nr * m_cols + nc;
+                if (!enterable(ahead) || m_g[ahead] != m_g[at] - 1)
+                    break;
+                at = ahead;
+                run++;
+            }
+            if (run > distance)
+            {
+                direction = d;
+                distance = run;
+            }
+        });
+        return true;
+    }
+
+    // steps from where the robot was at the last next_move() to the goal,
+    // UNREACHABLE if there is no known way
+    int steps_to_goal() const
+    {
+        return m_start >= 0 && m_start < static_cast<int>(m_g.size()) ? m_g[m_start] : UNREACHABLE;
+    }
+};
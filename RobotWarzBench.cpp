@@ -0,0 +1,306 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <cstring>
+#include <cstdlib>
+#include "Match.h"
+#include "OccupancyGrid.h"
+#include "SparseGrid.h"
+#include "Radar.h"
+#include "RobotLoader.h"
+#include "Rng.h"
+
+//
+// =========================================================
+//  RobotWarzBench - arena micro- and macro-benchmarks
+// =========================================================
+//
+// every benchmark runs once to warm up and then --reps more times; the
+// median repetition is reported, with the fastest beside it. boards and
+// match seeds come from --seed, so two builds run the same work.
+//
+
+struct BenchOptions
+{
+    int reps = 5;
+    int matches = 200;     // per pairing, per repetition
+    uint64_t seed = 1;
+};
+
+void print_usage()
+{
+    std::cout << "Usage: ./RobotWarzBench [--reps N] [--matches N] [--seed S] [filter]\n"
+              << "       runs every benchmark whose name contains filter (default all)\n";
+}
+
+//
+// =========================================================
+//  TIMING
+// =========================================================
+//
+
+struct Timing
+{
+    double median;    // seconds per run
+    double best;
+};
+
+// runs fn once to warm up and then reps times
+Timing time_runs(int reps, const std::function<void()> &fn)
+{
+    fn();
+
+    std::vector<double> secs;
+    for (int i = 0; i < reps; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        secs.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(secs.begin(), secs.end());
+    return {secs[secs.size() / 2], secs.front()};
+}
+
+// one line: median and best time per operation, for runs of ops operations
+void report(const std::string &name, long long ops, const Timing &timing)
+{
+    std::cout << "  " << std::left << std::setw(40) << name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(12) << timing.median * 1e9 / ops << " ns/op"
+              << std::setw(12) << timing.best * 1e9 / ops << " best" << std::defaultfloat << "\n";
+}
+
+//
+// =========================================================
+//  BOARDS
+// =========================================================
+//
+
+// scatters obstacles over about fill of the board, plus a handful of
+// robots, the way a match sets up
+template <class Grid>
+void fill_board(Grid &grid, double fill, Rng &rng)
+{
+    static const char types[] = {'M', 'M', 'M', 'P', 'F'};
+    long long cells = static_cast<long long>(grid.rows()) * grid.cols();
+    long long obstacles = static_cast<long long>(cells * fill);
+
+    for (long long i = 0; i < obstacles; i++)
+        grid.place_obstacle(types[rng.below(sizeof(types))], rng.below(grid.rows()), rng.below(grid.cols()));
+    for (int i = 0; i < 4; i++)
+        grid.place_robot(i, rng.below(grid.rows()), rng.below(grid.cols()));
+}
+
+//
+// =========================================================
+//  MICRO: RADAR
+// =========================================================
+//
+
+// every cell and direction of the board, the full sweep a robot could ask for
+void bench_radar_dense(const BenchOptions &opts, int size, double fill, const char *label)
+{
+    Rng rng(opts.seed);
+    OccupancyGrid grid(size, size);
+    fill_board(grid, fill, rng);
+    const RadarMasks *masks = RadarMasks::for_board(size, size);
+
+    std::vector<RadarObj> results;
+    long long found = 0;
+    long long ops = static_cast<long long>(size) * size * 9;
+
+    std::string name = "radar " + std::to_string(size) + "x" + std::to_string(size) + " " + label +
+                       (masks ? " (masks)" : " (walk)");
+    Timing timing = time_runs(opts.reps, [&]
+    {
+        for (int r = 0; r < size; r++)
+            for (int c = 0; c < size; c++)
+                for (int dir = 0; dir <= 8; dir++)
+                {
+                    perform_radar_scan(grid, masks, r, c, dir, results);
+                    found += static_cast<long long>(results.size());
+                }
+    });
+    report(name, ops, timing);
+
+    // keeps the scans from being optimised away
+    if (found < 0)
+        std::cout << found;
+}
+
+// random cells, since sweeping every cell of a tiled board would take all day
+void bench_radar_sparse(const BenchOptions &opts, int size, double fill, const char *label)
+{
+    Rng rng(opts.seed);
+    SparseGrid grid(size, size);
+    fill_board(grid, fill, rng);
+
+    const int scans = 20000;
+    std::vector<int> cells(scans * 3);
+    for (int i = 0; i < scans; i++)
+    {
+        cells[i * 3] = rng.below(size);
+        cells[i * 3 + 1] = rng.below(size);
+        cells[i * 3 + 2] = rng.below(9);
+    }
+
+    std::vector<RadarObj> results;
+    long long found = 0;
+
+    std::string name = "radar " + std::to_string(size) + "x" + std::to_string(size) + " " + label + " (tiles)";
+    Timing timing = time_runs(opts.reps, [&]
+    {
+        for (int i = 0; i < scans; i++)
+        {
+            perform_radar_scan(grid, cells[i * 3], cells[i * 3 + 1], cells[i * 3 + 2], results);
+            found += static_cast<long long>(results.size());
+        }
+    });
+    report(name, scans, timing);
+
+    if (found < 0)
+        std::cout << found;
+}
+
+//
+// =========================================================
+//  MICRO: TEXT BOARD
+// =========================================================
+//
+
+void bench_print_arena(const BenchOptions &opts, int size)
+{
+    Rng rng(opts.seed);
+    OccupancyGrid grid(size, size);
+    fill_board(grid, 1.0 / 80, rng);
+
+    const int frames = 200;
+
+    // timed with cout pointed at /dev/null, reported once it is back
+    std::ofstream null("/dev/null");
+    std::streambuf *saved = std::cout.rdbuf(null.rdbuf());
+    Timing timing = time_runs(opts.reps, [&]
+    {
+        for (int i = 0; i < frames; i++)
+            print_arena(i, grid);
+    });
+    std::cout.rdbuf(saved);
+
+    report("print_arena " + std::to_string(size) + "x" + std::to_string(size) + " > /dev/null", frames, timing);
+}
+
+//
+// =========================================================
+//  MACRO: MATCHES
+// =========================================================
+//
+
+// opts.matches headless one-on-one matches, seeds seed.., on this thread
+void bench_pairing(const BenchOptions &opts, const RobotLibrary &a, const RobotLibrary &b,
+                   const std::string &name)
+{
+    MatchOptions match_opts;
+    long long rounds = 0;
+
+    Timing timing = time_runs(opts.reps, [&]
+    {
+        rounds = 0;
+        for (int i = 0; i < opts.matches; i++)
+            rounds += play_match(a, b, opts.seed + i, match_opts).rounds;
+    });
+    report(name, opts.matches, timing);
+
+    // the seeds are the same every run, so rounds is too
+    double secs = timing.median;
+
+    std::cout << "  " << std::setw(40) << "" << std::fixed << std::setprecision(1) << std::setw(12)
+              << secs * 1e9 / rounds << " ns/round" << std::setprecision(0) << std::setw(12)
+              << rounds / secs << " rounds/sec" << std::defaultfloat << "\n";
+}
+
+//
+// =========================================================
+//  MAIN
+// =========================================================
+//
+
+bool parse_options(int argc, char **argv, BenchOptions &opts, std::string &filter)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--reps") == 0 && i + 1 < argc)
+            opts.reps = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--matches") == 0 && i + 1 < argc)
+            opts.matches = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            opts.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (argv[i][0] == '-')
+            return false;
+        else
+            filter = argv[i];
+    }
+    return opts.reps >= 1 && opts.matches >= 1;
+}
+
+int main(int argc, char **argv)
+{
+    BenchOptions opts;
+    std::string filter;
+    if (!parse_options(argc, argv, opts, filter))
+    {
+        print_usage();
+        return 0;
+    }
+
+    auto wanted = [&](const std::string &group) { return group.find(filter) != std::string::npos; };
+
+    std::cout << "===== RobotWarzBench: " << opts.reps << " reps after 1 warmup, seed " << opts.seed << " =====\n";
+
+    if (wanted("radar"))
+    {
+        std::cout << "radar\n";
+        bench_radar_dense(opts, 20, 0, "empty");
+        bench_radar_dense(opts, 20, 0.25, "cluttered");
+        bench_radar_dense(opts, 64, 0, "empty");
+        bench_radar_dense(opts, 64, 0.25, "cluttered");
+        bench_radar_dense(opts, 200, 0, "empty");
+        bench_radar_dense(opts, 200, 0.25, "cluttered");
+        bench_radar_sparse(opts, 4096, 0, "empty");
+        bench_radar_sparse(opts, 4096, 1.0 / 80, "cluttered");
+    }
+
+    if (wanted("print_arena"))
+    {
+        std::cout << "print_arena\n";
+        bench_print_arena(opts, 20);
+        bench_print_arena(opts, 64);
+    }
+
+    if (wanted("match"))
+    {
+        static const char *const robots[] = {"Toland", "Ratboy", "Flame_e_o"};
+        const int count = 3;
+
+        std::vector<RobotLibrary> libs(count);
+        for (int i = 0; i < count; i++)
+        {
+            std::string path = std::string("./Robot_") + robots[i] + ".so";
+            if (!open_robot_library(path.c_str(), libs[i]))
+                return -1;
+        }
+
+        std::cout << "match (" << opts.matches << " headless 20x20 matches per rep)\n";
+        for (int i = 0; i < count; i++)
+            for (int j = i + 1; j < count; j++)
+                bench_pairing(opts, libs[i], libs[j],
+                              std::string("match ") + robots[i] + " v " + robots[j]);
+
+        for (auto &lib : libs)
+            close_robot_library(lib);
+    }
+    return 0;
+}
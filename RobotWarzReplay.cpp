@@ -0,0 +1,189 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include "Match.h"
+#include "OccupancyGrid.h"
+#include "Replay.h"
+#include "TerminalRenderer.h"
+
+//
+// =========================================================
+//  RobotWarzReplay - look at a recorded .rwz match
+// =========================================================
+//
+// every round is rebuilt straight from its record, so jumping to round
+// 9000 costs the same as round 0 and no robot code is run.
+//
+
+void print_usage()
+{
+    std::cout << "Usage: ./RobotWarzReplay match.rwz                  summary\n"
+              << "       ./RobotWarzReplay match.rwz ROUND            board and actions after ROUND\n"
+              << "       ./RobotWarzReplay match.rwz --play [--from ROUND] [--fps F]\n";
+}
+
+std::string robot_name(const ReplayReader &replay, int robot)
+{
+    ReplayRobotInfo info = replay.robot_info(robot);
+    return std::string(info.name, strnlen(info.name, sizeof(info.name)));
+}
+
+// the board as it stood at the end of the given record
+void build_grid(const ReplayReader &replay, size_t round, OccupancyGrid &grid)
+{
+    const ReplayHeader &header = replay.header();
+
+    for (int i = 0; i < header.obstacle_count; i++)
+    {
+        ReplayObstacle ob = replay.obstacle(i);
+        grid.place_obstacle(ob.type, ob.row, ob.col);
+    }
+
+    for (int i = 0; i < header.robot_count; i++)
+    {
+        ReplayRobot rec = replay.robot(round, i);
+        if (rec.health > 0)
+            grid.place_robot(i, rec.row, rec.col);
+        else
+            grid.kill_robot(rec.row, rec.col);
+    }
+}
+
+std::string status_line(const ReplayReader &replay, size_t round, int robot)
+{
+    ReplayRobot rec = replay.robot(round, robot);
+
+    std::string line = robot_name(replay, robot) + ": H: " + std::to_string(rec.health) +
+                       "  A: " + std::to_string(rec.armor) +
+                       "  at: (" + std::to_string(rec.row) + "," + std::to_string(rec.col) + ")" +
+                       "  radar " + std::to_string(rec.radar_dir);
+
+    if (rec.shot)
+        line += "  shot (" + std::to_string(rec.shot_row) + "," + std::to_string(rec.shot_col) +
+                ") hits " + std::to_string(rec.hits) + " dmg " + std::to_string(rec.damage);
+
+    line += "  move " + std::to_string(rec.move_dir) + "x" + std::to_string(rec.move_dist);
+    return line;
+}
+
+int print_summary(const ReplayReader &replay)
+{
+    const ReplayHeader &header = replay.header();
+
+    std::cout << "arena " << header.rows << "x" << header.cols
+              << " | " << header.obstacle_count << " obstacles"
+              << " | seed " << header.seed
+              << " | " << replay.round_count() << " rounds recorded\n";
+
+    int alive = 0;
+    int last_alive = -1;
+    for (int i = 0; i < header.robot_count; i++)
+    {
+        ReplayRobotInfo info = replay.robot_info(i);
+        std::cout << "  " << OccupancyGrid::robot_glyph(i) << " " << robot_name(replay, i)
+                  << " starts at (" << info.start_row << "," << info.start_col << ")";
+
+        if (replay.round_count() > 0)
+        {
+            ReplayRobot last = replay.robot(replay.round_count() - 1, i);
+            std::cout << ", ends with " << last.health << " health";
+            if (last.health > 0)
+            {
+                alive++;
+                last_alive = i;
+            }
+        }
+        std::cout << "\n";
+    }
+
+    if (alive == 1)
+        std::cout << "winner: " << OccupancyGrid::robot_glyph(last_alive) << " "
+                  << robot_name(replay, last_alive) << "\n";
+    else if (replay.round_count() > 0)
+        std::cout << "no winner\n";
+
+    return 0;
+}
+
+int print_round(const ReplayReader &replay, size_t round)
+{
+    const ReplayHeader &header = replay.header();
+
+    OccupancyGrid grid(header.rows, header.cols);
+    build_grid(replay, round, grid);
+    print_arena(static_cast<int>(replay.round_number(round)), grid);
+
+    for (int i = 0; i < header.robot_count; i++)
+        std::cout << OccupancyGrid::robot_glyph(i) << " " << status_line(replay, round, i) << "\n";
+    return 0;
+}
+
+int play(const ReplayReader &replay, size_t from, double fps)
+{
+    const ReplayHeader &header = replay.header();
+    TerminalRenderer renderer(header.rows, header.cols, fps);
+    std::vector<std::string> status(header.robot_count);
+
+    for (size_t round = from; round < replay.round_count(); round++)
+    {
+        OccupancyGrid grid(header.rows, header.cols);
+        build_grid(replay, round, grid);
+
+        for (int i = 0; i < header.robot_count; i++)
+            status[i] = status_line(replay, round, i);
+
+        renderer.draw(static_cast<int>(replay.round_number(round)), grid, status);
+    }
+
+    renderer.finish();
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        print_usage();
+        return 0;
+    }
+
+    ReplayReader replay;
+    if (!replay.open(argv[1]))
+        return -1;
+
+    if (argc == 2)
+        return print_summary(replay);
+
+    bool playing = false;
+    long from = 0;
+    double fps = 10;
+    long round = -1;
+
+    for (int i = 2; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--play") == 0)
+            playing = true;
+        else if (std::strcmp(argv[i], "--from") == 0 && i + 1 < argc)
+            from = std::atol(argv[++i]);
+        else if (std::strcmp(argv[i], "--fps") == 0 && i + 1 < argc)
+            fps = std::atof(argv[++i]);
+        else
+            round = std::atol(argv[i]);
+    }
+
+    if (playing)
+    {
+        if (from < 0)
+            from = 0;
+        return play(replay, static_cast<size_t>(from), fps);
+    }
+
+    if (round < 0 || static_cast<size_t>(round) >= replay.round_count())
+    {
+        std::cerr << "ERROR: round must be between 0 and " << replay.round_count() - 1 << "\n";
+        return -1;
+    }
+    return print_round(replay, static_cast<size_t>(round));
+}
@@ -1,8 +1,11 @@
 #include "RobotBase.h"
+#include "Rng.h"
+#include "RobotMap.h"
+#include "RobotPath.h"
 #include <cstdlib>
 #include <ctime>
-#include <set>
 #include <cmath>
+#include <algorithm>
 #include <limits>
 #include <utility>
 
@@ -16,7 +19,12 @@ private:
     int radar_direction = 1; // Radar scanning direction (1-8)
     bool fixed_radar = false; // Tracks whether radar is locked on a target
     const int max_range = 4; // Maximum range of the flamethrower
-    std::set<std::pair<int, int>> obstacles_memory; // Memory of obstacles
+    RobotMap obstacles_memory; // Memory of obstacles
+    RobotPath chase_path;  // Route to the target
+    RobotPath wander_path; // Route to a random spot, kept while chasing so it needn't be searched again
+
+    Rng own_rng; // Used when the arena doesn't hand us a stream
+    Rng* rng = &own_rng;
 
     // Helper function to calculate Manhattan distance
     int calculate_distance(int row1, int col1, int row2, int col2) const 
@@ -50,25 +58,36 @@ private:
     // Update the memory of obstacles
     void update_obstacle_memory(const std::vector<RadarObj>& radar_results) 
     {
-        for (const auto& obj : radar_results) 
-        {
-            if (obj.m_type == 'M' || obj.m_type == 'P' || obj.m_type == 'F') 
-            {
-                obstacles_memory.insert({obj.m_row, obj.m_col});
-            }
-        }
+        obstacles_memory.fit(m_board_row_max, m_board_col_max);
+        obstacles_memory.observe(radar_results);
     }
 
-    // Check if a cell is passable
-    bool is_passable(int row, int col) const 
+    // Pick somewhere new to wander to
+    void pick_wander_goal() 
     {
-        return obstacles_memory.find({row, col}) == obstacles_memory.end();
+        wander_path.set_goal(rng->below(m_board_row_max), rng->below(m_board_col_max));
     }
 
 public:
-    Robot_Flame_e_o() : RobotBase(2, 5, flamethrower) 
+    Robot_Flame_e_o() : RobotBase(2, 5, flamethrower), own_rng(static_cast<uint64_t>(std::time(nullptr))) 
+    {
+    }
+
+    // Use the arena's per-match stream so matches replay exactly
+    void set_rng(Rng* rng_in) 
+    {
+        rng = rng_in;
+    }
+
+    // Copy mid-match; a copy drawing from its own stream must not draw from ours
+    Robot_Flame_e_o* clone() const 
     {
-        std::srand(static_cast<unsigned int>(std::time(nullptr))); // Seed for random movement
+        Robot_Flame_e_o* copy = new Robot_Flame_e_o(*this);
+        if (rng == &own_rng) 
+        {
+            copy->rng = &copy->own_rng;
+        }
+        return copy;
     }
 
     // Set the radar direction for scanning
@@ -141,34 +160,39 @@ public:
 
         if (target_found) 
         {
-            // Move toward the target while avoiding obstacles
-            int row_step = (target_row > current_row) ? 1 : (target_row < current_row) ? -1 : 0;
-            int col_step = (target_col > current_col) ? 1 : (target_col < current_col) ? -1 : 0;
-
-            // Prioritize row movement, then column movement
-            if (is_passable(current_row + row_step, current_col)) 
+            // Close in on the target around known obstacles, stopping next to it
+            chase_path.set_goal(target_row, target_col);
+            if (chase_path.next_move(obstacles_memory, current_row, current_col, get_move_speed(), move_direction, move_distance)) 
             {
-                move_direction = (row_step > 0) ? 5 : 1; // Down or Up
-                move_distance = 1;
-            } 
-            else if (is_passable(current_row, current_col + col_step)) 
+                move_distance = std::min(move_distance, chase_path.steps_to_goal() - 1);
+                if (move_distance <= 0) 
+                {
+                    move_direction = 0;
+                    move_distance = 0;
+                }
+                return;
+            }
+
+            // No known way there; wander instead
+        }
+
+        // Wander between random spots when no target is found
+        for (int attempt = 0; attempt < 4; attempt++) 
+        {
+            if (!wander_path.has_goal() || (wander_path.goal_row() == current_row && wander_path.goal_col() == current_col)) 
             {
-                move_direction = (col_step > 0) ? 3 : 7; // Right or Left
-                move_distance = 1;
-            } 
-            else 
+                pick_wander_goal();
+            }
+            if (wander_path.next_move(obstacles_memory, current_row, current_col, get_move_speed(), move_direction, move_distance) && move_distance > 0) 
             {
-                // Stay in place if movement is blocked
-                move_direction = 0;
-                move_distance = 0;
+                return;
             }
-
-            return;
+            pick_wander_goal();
         }
 
-        // Random movement if no target is found
-        move_direction = (std::rand() % 8) + 1; // Random direction (1-8)
-        move_distance = 1; // Move 1 space
+        // Boxed in as far as we know
+        move_direction = 0;
+        move_distance = 0;
     }
 };
 
@@ -176,4 +200,16 @@ public:
 extern "C" RobotBase* create_robot() 
 {
     return new Robot_Flame_e_o();
-}
\ No newline at end of file
+}
+
+// Optional hook: the arena passes in this robot's random stream
+extern "C" void attach_rng(RobotBase* robot, Rng* rng) 
+{
+    static_cast<Robot_Flame_e_o*>(robot)->set_rng(rng);
+}
+
+// Optional hook: copy this robot mid-match (the arena re-attaches the random stream)
+extern "C" RobotBase* clone_robot(const RobotBase* robot) 
+{
+    return static_cast<const Robot_Flame_e_o*>(robot)->clone();
+}
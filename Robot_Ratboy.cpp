@@ -1,7 +1,8 @@
 #include "RobotBase.h"
+#include "RobotMap.h"
+#include "RobotPath.h"
 #include <vector>
 #include <iostream>
-#include <algorithm>
 
 class Robot_Ratboy : public RobotBase
 {
@@ -11,15 +12,9 @@ private:
     int to_shoot_row = -1;
     int to_shoot_col = -1;
 
-    std::vector<RadarObj> known_obstacles;
-
-    bool is_obstacle(int row, int col) const
-    {
-        return std::any_of(known_obstacles.begin(),
-                           known_obstacles.end(),
-                           [&](const RadarObj &obj)
-                           { return obj.m_row == row && obj.m_col == col; });
-    }
+    RobotMap known_map;
+    RobotPath route_down; // one search per end of the sweep, so turning
+    RobotPath route_up;   // around doesn't start a search over
 
     void clear_target()
     {
@@ -27,16 +22,6 @@ private:
         to_shoot_col = -1;
     }
 
-    void add_obstacle(const RadarObj &obj)
-    {
-        // FIXED WARNING: parentheses around OR chain
-        if ((obj.m_type == 'M' || obj.m_type == 'P' || obj.m_type == 'F') &&
-            !is_obstacle(obj.m_row, obj.m_col))
-        {
-            known_obstacles.push_back(obj);
-        }
-    }
-
 public:
     Robot_Ratboy() : RobotBase(3, 4, railgun)
     {
@@ -56,10 +41,11 @@ public:
     {
         clear_target();
 
+        known_map.fit(m_board_row_max, m_board_col_max);
+        known_map.observe(results);
+
         for (const auto &obj : results)
         {
-            add_obstacle(obj);
-
             if (obj.m_type == 'R' && to_shoot_row == -1)
             {
                 to_shoot_row = obj.m_row;
@@ -84,45 +70,24 @@ public:
     {
         int r, c;
         get_current_location(r, c);
-        int mv = get_move_speed();
 
-        // Sweep left
-        if (c > 0)
-        {
-            move_direction = 7; // left
-            move_distance = std::min(mv, c);
-            return;
-        }
+        // Sweep up and down the left wall, around whatever is in the way
+        route_down.set_goal(m_board_row_max - 1, 0);
+        route_up.set_goal(0, 0);
 
-        // Vertical sweep
-        if (m_moving_down)
+        for (int attempt = 0; attempt < 2; attempt++)
         {
-            if (r + mv < m_board_row_max - 1)
-            {
-                move_direction = 5; // down
-                move_distance = mv;
-            }
-            else
-            {
-                m_moving_down = false;
-                move_direction = 1;
-                move_distance = 1;
-            }
-        }
-        else
-        {
-            if (r - mv >= 0)
-            {
-                move_direction = 1; // up
-                move_distance = mv;
-            }
-            else
-            {
-                m_moving_down = true;
-                move_direction = 5;
-                move_distance = 1;
-            }
+            RobotPath &route = m_moving_down ? route_down : route_up;
+            if (route.next_move(known_map, r, c, get_move_speed(), move_direction, move_distance) &&
+                move_distance > 0)
+                return;
+
+            // at that end already, or it can't be reached: turn around
+            m_moving_down = !m_moving_down;
         }
+
+        move_direction = 0;
+        move_distance = 0;
     }
 };
 
@@ -130,3 +95,8 @@ extern "C" RobotBase *create_robot()
 {
     return new Robot_Ratboy();
 }
+
+extern "C" RobotBase *clone_robot(const RobotBase *robot)
+{
+    return new Robot_Ratboy(*static_cast<const Robot_Ratboy *>(robot));
+}
@@ -1,7 +1,7 @@
 #include "RobotBase.h"
+#include "RobotMap.h"
 #include <vector>
 #include <iostream>
-#include <algorithm>
 
 //
 //  Robot_Toland — Advanced Sniper
@@ -20,22 +20,11 @@ private:
     bool m_has_target = false;
 
     // Obstacle memory
-    std::vector<RadarObj> m_obstacles;
+    RobotMap m_map;
 
     // Patrol direction: 1 = right, -1 = left
     int m_patrol_dir = 1;
 
-    // Sniper rarely moves; move only if needed
-    bool is_obstacle(int r, int c) const
-    {
-        return std::any_of(
-            m_obstacles.begin(),
-            m_obstacles.end(),
-            [&](const RadarObj& obj) {
-                return obj.m_row == r && obj.m_col == c;
-            });
-    }
-
 public:
     // Toland: low movement, medium armor, railgun
     Robot_Toland() : RobotBase(2, 3, railgun) 
@@ -58,15 +47,12 @@ public:
     {
         m_has_target = false;
 
+        // Save static obstacles
+        m_map.fit(m_board_row_max, m_board_col_max);
+        m_map.observe(radar_results);
+
         for (const auto& obj : radar_results)
         {
-            // Save static obstacles
-            if ((obj.m_type == 'M' || obj.m_type == 'P' || obj.m_type == 'F') &&
-                !is_obstacle(obj.m_row, obj.m_col))
-            {
-                m_obstacles.push_back(obj);
-            }
-
             // Acquire target
             if (obj.m_type == 'R' && !m_has_target)
             {
@@ -110,7 +96,7 @@ public:
         int ahead_r = r;
         int ahead_c = c + 1;
 
-        if (is_obstacle(ahead_r, ahead_c))
+        if (m_map.is_obstacle(ahead_r, ahead_c))
         {
             move_direction = 1; // move up
             move_distance = 1;
@@ -166,3 +152,9 @@ extern "C" RobotBase* create_robot()
 {
     return new Robot_Toland();
 }
+
+// Copy, for forking a match mid-game
+extern "C" RobotBase* clone_robot(const RobotBase* robot)
+{
+    return new Robot_Toland(*static_cast<const Robot_Toland*>(robot));
+}
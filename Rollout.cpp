@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "Rollout.h"
+#include "Match.h"
+#include "WorkStealingPool.h"
+
+// keeps the rollouts' streams apart from the matches of a batch, which
+// use seed, seed + 1, ...
+static const uint64_t ROLLOUT_SALT = 0x726f6c6c6f757473ULL;   // "rollouts"
+
+//
+// =========================================================
+//  ROBOTS
+// =========================================================
+//
+
+// one lineup of robots with the random streams they were handed, deleted
+// together
+struct RobotSet
+{
+    std::vector<RobotBase *> robots;
+    std::vector<Rng> rngs;     // never resized once the robots hold pointers into it
+
+    RobotSet() = default;
+    RobotSet(const RobotSet &) = delete;
+    RobotSet &operator=(const RobotSet &) = delete;
+
+    ~RobotSet()
+    {
+        for (auto *robot : robots)
+            delete robot;
+    }
+};
+
+// fresh robots, streams split off rng the way play_match does it
+static void create_robots(const std::vector<const RobotLibrary *> &lineup, Rng &rng, RobotSet &set)
+{
+    for (size_t i = 0; i < lineup.size(); i++)
+        set.rngs.push_back(rng.split());
+
+    for (size_t i = 0; i < lineup.size(); i++)
+    {
+        set.robots.push_back(lineup[i]->create());
+        if (lineup[i]->attach_rng)
+            lineup[i]->attach_rng(set.robots[i], &set.rngs[i]);
+    }
+}
+
+// copies of the paused robots, each with a new stream split off rng
+static void clone_robots(const std::vector<const RobotLibrary *> &lineup, const RobotSet &from, Rng &rng,
+                         RobotSet &set)
+{
+    for (size_t i = 0; i < lineup.size(); i++)
+        set.rngs.push_back(rng.split());
+
+    for (size_t i = 0; i < lineup.size(); i++)
+    {
+        set.robots.push_back(lineup[i]->clone(from.robots[i]));
+        if (lineup[i]->attach_rng)
+            lineup[i]->attach_rng(set.robots[i], &set.rngs[i]);
+    }
+}
+
+//
+// =========================================================
+//  REPORT
+// =========================================================
+//
+
+static void print_outcome(const MatchResult &result, const std::vector<std::string> &names)
+{
+    if (result.stalemate)
+        std::cout << "stalemate after ";
+    else if (result.winner < 0)
+        std::cout << "draw after ";
+    else
+        std::cout << OccupancyGrid::robot_glyph(result.winner) << " (" << names[result.winner] << ") wins in ";
+    std::cout << result.rounds << " rounds";
+}
+
+static void print_pause(const ArenaState &state, const std::vector<std::string> &names, uint64_t seed)
+{
+    std::cout << "===== seed " << seed << " paused before round " << state.round << " =====\n";
+    for (size_t i = 0; i < state.robots.size(); i++)
+    {
+        const RobotState &robot = state.robots[i];
+        std::cout << "  " << robot.glyph << " " << std::left << std::setw(24) << names[i] << std::right;
+        if (!robot.alive)
+        {
+            std::cout << "destroyed\n";
+            continue;
+        }
+        std::cout << "at (" << robot.row << "," << robot.col << ")  health " << robot.health
+                  << "  armor " << robot.armor;
+        if (robot.move == 0)
+            std::cout << "  trapped";
+        std::cout << "\n";
+    }
+}
+
+// share of n as a percentage, with a 95% normal-approximation interval
+static void print_share(const std::string &label, long long count, long long n)
+{
+    double p = static_cast<double>(count) / n;
+    double margin = 1.96 * std::sqrt(p * (1 - p) / n);
+    std::cout << "  " << std::left << std::setw(28) << label << std::right << std::fixed << std::setprecision(1)
+              << std::setw(6) << 100 * p << "% +/- " << std::setw(4) << 100 * margin << "%  (" << count << ")\n"
+              << std::defaultfloat;
+}
+
+//
+// =========================================================
+//  ROLLOUTS
+// =========================================================
+//
+
+int run_rollouts(const std::vector<const RobotLibrary *> &lineup, uint64_t seed, int from_round,
+                 int rollouts, int threads, const MatchOptions &match_opts)
+{
+    if (match_opts.sandbox || is_sparse_board(match_opts.rows, match_opts.cols))
+    {
+        std::cerr << "ERROR: rollouts need an in-process match on a board up to "
+                  << SPARSE_MIN_CELLS << " cells\n";
+        return -1;
+    }
+    if (match_opts.turn_budget_ms > 0)
+    {
+        // a robot left stuck in a call is gone from its slot and can't be copied
+        std::cerr << "ERROR: rollouts can't run with a --turn-budget\n";
+        return -1;
+    }
+    for (const auto *lib : lineup)
+    {
+        if (!lib->clone)
+        {
+            std::cerr << "ERROR: clone_robot() not found in " << lib->path << "\n";
+            return -1;
+        }
+    }
+
+    MatchOptions opts = match_opts;
+    opts.seed = seed;
+    std::vector<std::string> names;
+    for (const auto *lib : lineup)
+        names.push_back(std::filesystem::path(lib->path).stem().string());
+    opts.robot_names = names;
+
+    //
+    // the match itself, up to the pause
+    //
+    Rng rng(seed);
+    RobotSet original;
+    create_robots(lineup, rng, original);
+
+    ArenaState state;
+    MatchOptions pausing = opts;
+    pausing.pause_round = from_round;
+    pausing.paused = &state;
+    MatchResult result = run_match(original.robots, rng, pausing);
+
+    if (result.winner != MATCH_PAUSED)
+    {
+        std::cout << "seed " << seed << " was over before round " << from_round << ": ";
+        print_outcome(result, names);
+        std::cout << "\n";
+        return 0;
+    }
+    print_pause(state, names, seed);
+
+    //
+    // the rollouts
+    //
+    std::vector<std::atomic<long long>> wins(lineup.size());
+    std::atomic<long long> draws{0}, stalemates{0}, rounds{0};
+
+    // the forks would bury the match's own events
+    MatchOptions fork_opts = opts;
+    fork_opts.events = nullptr;
+
+    auto start = std::chrono::steady_clock::now();
+    WorkStealingPool pool(threads);
+    pool.run(rollouts, [&](int k)
+    {
+        Rng fork_rng(Rng(seed ^ ROLLOUT_SALT).next() + static_cast<uint64_t>(k));
+        RobotSet fork;
+        clone_robots(lineup, original, fork_rng, fork);
+
+        MatchResult outcome = resume_match(state, fork.robots, fork_rng, fork_opts);
+        if (outcome.winner >= 0)
+            wins[outcome.winner]++;
+        else
+            draws++;
+        stalemates += outcome.stalemate;
+        rounds += outcome.rounds - state.round;
+    });
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << rollouts << " rollouts on " << pool.size() << " threads in " << std::fixed << std::setprecision(2)
+              << elapsed.count() << "s | " << std::setprecision(0) << rollouts / elapsed.count()
+              << " rollouts/sec | " << rounds.load() / elapsed.count() << " rounds/sec\n" << std::defaultfloat;
+
+    for (size_t i = 0; i < lineup.size(); i++)
+        print_share(std::string(1, OccupancyGrid::robot_glyph(static_cast<int>(i))) + " " + names[i],
+                    wins[i].load(), rollouts);
+    print_share("draw (" + std::to_string(stalemates.load()) + " stalemates)", draws.load(), rollouts);
+
+    //
+    // and what really happened: the paused robots and stream, played on
+    //
+    Rng carry_on = state.rng;
+    MatchResult actual = resume_match(state, original.robots, carry_on, opts);
+    std::cout << "as played: ";
+    print_outcome(actual, names);
+    std::cout << "\n";
+    return 0;
+}
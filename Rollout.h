@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "Match.h"
+#include "RobotLoader.h"
+
+// "who wins from here?" without replaying from round 0 every time.
+//
+// plays the match for seed up to the start of from_round and pauses it
+// (ArenaState), then plays it out rollouts times from there, spread over
+// threads workers with work stealing. every rollout starts from its own copy
+// of the paused arena and of the robots (clone_robot, see RobotLoader.h),
+// with arena and robot random streams of its own, so the rollouts explore
+// different futures but rollout k is the same on every run. the paused
+// match itself is then played on as it would have gone.
+//
+// prints the state at the pause, each robot's share of rollout wins with a
+// 95% interval, and what really happened. returns non-zero if a robot
+// can't be copied or the board can't be paused (tiled boards, --sandbox,
+// --turn-budget).
+int run_rollouts(const std::vector<const RobotLibrary *> &lineup, uint64_t seed, int from_round,
+                 int rollouts, int threads, const MatchOptions &match_opts);
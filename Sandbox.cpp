@@ -0,0 +1,250 @@
+#include <cstring>
+#include <new>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "Sandbox.h"
+
+extern char **environ;
+
+//
+// =========================================================
+//  STARTING A HOST
+// =========================================================
+//
+
+// maps a fresh, zeroed SandboxShared. -1 on failure.
+static int create_shared(SandboxShared *&shared)
+{
+    int fd = memfd_create("robotwarz-sandbox", MFD_CLOEXEC);
+    if (fd < 0)
+        return -1;
+
+    if (ftruncate(fd, sizeof(SandboxShared)) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    void *mem = mmap(nullptr, sizeof(SandboxShared), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mem == MAP_FAILED)
+    {
+        close(fd);
+        return -1;
+    }
+
+    shared = new (mem) SandboxShared;
+    return fd;
+}
+
+// runs this same executable as a host, with the memfd as SANDBOX_FD.
+// -1 on failure.
+static pid_t start_host(const std::string &library_path, int fd)
+{
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, fd, SANDBOX_FD);
+
+    std::string exe = "RobotWarz";
+    std::string flag = ROBOT_HOST_FLAG;
+    std::string lib = library_path;
+    char *argv[] = {exe.data(), flag.data(), lib.data(), nullptr};
+
+    pid_t pid;
+    int err = posix_spawn(&pid, "/proc/self/exe", &actions, nullptr, argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+    return err == 0 ? pid : -1;
+}
+
+// what became of a child that has exited
+static std::string exit_reason(int status)
+{
+    if (WIFSIGNALED(status))
+        return "signal " + std::to_string(WTERMSIG(status));
+    if (WIFEXITED(status))
+        return "exit " + std::to_string(WEXITSTATUS(status));
+    return "lost";
+}
+
+SandboxedRobot *SandboxedRobot::spawn(const RobotLibrary &lib, const Rng *rng)
+{
+    SandboxShared *shared = nullptr;
+    int fd = create_shared(shared);
+    pid_t pid = -1;
+
+    if (fd >= 0)
+    {
+        if (rng)
+        {
+            std::memcpy(shared->rng, rng, sizeof(Rng));
+            shared->has_rng = 1;
+        }
+        pid = start_host(lib.path, fd);
+        close(fd);
+    }
+
+    // wait for the host to build the robot, or to die trying
+    std::string failure = "couldn't start a host";
+    bool ready = false;
+    while (pid > 0)
+    {
+        uint32_t state = shared->state.load();
+        if (state == HOST_READY)
+        {
+            ready = true;
+            break;
+        }
+        if (state == HOST_FAILED)
+        {
+            failure = "couldn't load " + lib.path;
+            break;
+        }
+
+        int status;
+        if (waitpid(pid, &status, WNOHANG) == pid)
+        {
+            pid = -1;
+            failure = exit_reason(status);
+            break;
+        }
+
+        timespec timeout{0, 5 * 1000 * 1000};
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&shared->state), FUTEX_WAIT,
+                HOST_STARTING, &timeout, nullptr, 0);
+    }
+
+    if (!ready)
+    {
+        auto *robot = new SandboxedRobot(2, 0, railgun, pid, shared);
+        robot->m_crashed = true;
+        robot->m_crash_reason = failure;
+        return robot;
+    }
+
+    auto *robot = new SandboxedRobot(shared->move, shared->armor,
+                                     static_cast<WeaponType>(shared->weapon), pid, shared);
+    robot->m_name = std::string(shared->name, strnlen(shared->name, sizeof(shared->name)));
+    return robot;
+}
+
+SandboxedRobot::SandboxedRobot(int move, int armor, WeaponType weapon, pid_t pid, SandboxShared *shared)
+    : RobotBase(move, armor, weapon), m_pid(pid), m_shared(shared)
+{
+}
+
+SandboxedRobot::~SandboxedRobot()
+{
+    // the host has nothing to save, so it isn't asked to leave
+    if (m_pid > 0)
+    {
+        kill(m_pid, SIGKILL);
+        waitpid(m_pid, nullptr, 0);
+    }
+    if (m_shared)
+        munmap(m_shared, sizeof(SandboxShared));
+}
+
+//
+// =========================================================
+//  CALLS
+// =========================================================
+//
+
+bool SandboxedRobot::child_alive()
+{
+    int status;
+    if (waitpid(m_pid, &status, WNOHANG) != m_pid)
+        return true;
+
+    m_pid = -1;
+    m_crash_reason = exit_reason(status);
+    m_crashed = true;
+    return false;
+}
+
+bool SandboxedRobot::send(RobotCallback which, const std::vector<RadarObj> *radar)
+{
+    if (crashed())
+        return false;
+
+    auto alive = [this] { return child_alive(); };
+
+    SandboxSlot slot;
+    SandboxRequest &req = slot.request;
+    req.which = which;
+    req.radar_count = radar ? static_cast<int32_t>(radar->size()) : 0;
+    req.health = get_health();
+    req.armor = get_armor();
+    req.move = get_move_speed();
+    req.grenades = get_grenades();
+    get_current_location(req.row, req.col);
+    req.rows = m_board_row_max;
+    req.cols = m_board_col_max;
+    req.character = m_character;
+
+    if (!m_shared->requests.push(slot, alive))
+        return false;
+
+    if (radar)
+    {
+        // a long scan streams through the ring while the host reads it
+        for (const auto &obj : *radar)
+        {
+            slot.radar = {obj.m_type, obj.m_row, obj.m_col};
+            if (!m_shared->requests.push(slot, alive))
+                return false;
+        }
+    }
+    return true;
+}
+
+bool SandboxedRobot::receive(SandboxReply &reply)
+{
+    SandboxSlot slot;
+    if (!m_shared->replies.pop(slot, [this] { return child_alive(); }))
+        return false;
+    reply = slot.reply;
+    return true;
+}
+
+void SandboxedRobot::get_radar_direction(int &radar_direction)
+{
+    SandboxReply reply;
+    if (send(CALL_RADAR_DIRECTION, nullptr) && receive(reply))
+        radar_direction = reply.first;
+    else
+        radar_direction = 0;
+}
+
+void SandboxedRobot::process_radar_results(const std::vector<RadarObj> &radar_results)
+{
+    SandboxReply reply;
+    if (send(CALL_PROCESS_RADAR, &radar_results))
+        receive(reply);
+}
+
+bool SandboxedRobot::get_shot_location(int &shot_row, int &shot_col)
+{
+    SandboxReply reply;
+    if (!send(CALL_SHOT_LOCATION, nullptr) || !receive(reply))
+        return false;
+    shot_row = reply.first;
+    shot_col = reply.second;
+    return reply.shoots != 0;
+}
+
+void SandboxedRobot::get_move_direction(int &direction, int &distance)
+{
+    SandboxReply reply;
+    if (send(CALL_MOVE_DIRECTION, nullptr) && receive(reply))
+    {
+        direction = reply.first;
+        distance = reply.second;
+    }
+    else
+    {
+        direction = 0;
+        distance = 0;
+    }
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+#include "RobotBase.h"
+#include "RobotLoader.h"
+#include "Rng.h"
+#include "SpscRing.h"
+#include "Profiler.h"
+
+// the arena re-runs itself with this flag to host a sandboxed robot, and
+// hands the host its shared memory as this file descriptor
+static const char ROBOT_HOST_FLAG[] = "--robot-host";
+static const int SANDBOX_FD = 3;
+
+//
+// =========================================================
+//  SHARED MEMORY LAYOUT
+// =========================================================
+//
+
+// the arena's view of the robot, sent ahead of every call so the hosted
+// robot sees the same health, position and so on that the match does
+struct SandboxRequest
+{
+    int32_t which;       // RobotCallback
+    int32_t radar_count; // RadarEntry slots that follow a CALL_PROCESS_RADAR
+    int32_t health, armor, move, grenades;
+    int32_t row, col;
+    int32_t rows, cols;
+    int32_t character;
+};
+
+struct SandboxReply
+{
+    int32_t first, second;
+    int32_t shoots;
+};
+
+struct RadarEntry
+{
+    int32_t type, row, col;
+};
+
+union SandboxSlot
+{
+    SandboxRequest request;
+    SandboxReply reply;
+    RadarEntry radar;
+};
+
+enum SandboxState : uint32_t { HOST_STARTING, HOST_READY, HOST_FAILED };
+
+// one memfd per robot, mapped by the arena and by the host. the arena fills
+// in the random stream, the host answers with the robot's stats.
+struct SandboxShared
+{
+    std::atomic<uint32_t> state{HOST_STARTING};   // also a futex word
+
+    unsigned char rng[sizeof(Rng)];
+    int32_t has_rng = 0;
+
+    int32_t move = 0, armor = 0, weapon = 0;
+    char name[64] = {};
+
+    SpscRing<SandboxSlot, 1024> requests;   // arena -> host
+    SpscRing<SandboxSlot, 4> replies;       // host -> arena
+};
+
+//
+// =========================================================
+//  SANDBOXED ROBOT
+// =========================================================
+//
+
+// a robot running in a child process of its own, so a crash in robot code
+// kills only that process. the arena keeps the robot's stats here as usual;
+// each callback sends them over the request ring along with the call, and
+// the answer comes back on the reply ring.
+//
+// a robot whose process dies, or never comes up, reports crashed() and
+// answers every call with nothing: no scan, no shot, no move.
+class SandboxedRobot : public RobotBase
+{
+private:
+    pid_t m_pid;
+    SandboxShared *m_shared;
+    std::atomic<bool> m_crashed{false};
+    std::string m_crash_reason;
+
+    SandboxedRobot(int move, int armor, WeaponType weapon, pid_t pid, SandboxShared *shared);
+
+    bool child_alive();
+    bool send(RobotCallback which, const std::vector<RadarObj> *radar);
+    bool receive(SandboxReply &reply);
+
+public:
+    // starts a host for lib and waits for it to build the robot. rng, if
+    // given, becomes the hosted robot's own stream. never returns null: a
+    // robot that can't be started comes back already crashed.
+    static SandboxedRobot *spawn(const RobotLibrary &lib, const Rng *rng);
+
+    ~SandboxedRobot() override;
+
+    bool crashed() const { return m_crashed.load(); }
+
+    // "signal 11", "exit 1" and so on. only read once crashed() is true.
+    const std::string &crash_reason() const { return m_crash_reason; }
+
+    void get_radar_direction(int &radar_direction) override;
+    void process_radar_results(const std::vector<RadarObj> &radar_results) override;
+    bool get_shot_location(int &shot_row, int &shot_col) override;
+    void get_move_direction(int &direction, int &distance) override;
+};
+
+// entry point of the host process (RobotWarz --robot-host lib.so). the
+// shared memory arrives as SANDBOX_FD.
+int run_robot_host(const char *library_path);
@@ -0,0 +1,96 @@
+#include <cstring>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include "Sandbox.h"
+#include "Watchdog.h"
+
+//
+// =========================================================
+//  ROBOT HOST (child process)
+// =========================================================
+//
+
+// brings the hosted robot up to date with the arena. every stat only ever
+// goes down, so the robot's own final methods can get it there.
+static void sync_robot(RobotBase *robot, const SandboxRequest &req)
+{
+    robot->move_to(req.row, req.col);
+    robot->set_boundaries(req.rows, req.cols);
+    robot->m_character = static_cast<char>(req.character);
+
+    if (req.health < robot->get_health())
+        robot->take_damage(robot->get_health() - req.health);
+    if (req.armor < robot->get_armor())
+        robot->reduce_armor(robot->get_armor() - req.armor);
+    if (req.move == 0 && robot->get_move_speed() != 0)
+        robot->disable_movement();
+    while (robot->get_grenades() > req.grenades)
+        robot->decrement_grenades();
+}
+
+static void set_state(SandboxShared *shared, SandboxState state)
+{
+    shared->state.store(state);
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&shared->state), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+
+int run_robot_host(const char *library_path)
+{
+    // go down with the arena rather than wait on the ring forever
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+    if (getppid() == 1)
+        return 1;
+
+    void *mem = mmap(nullptr, sizeof(SandboxShared), PROT_READ | PROT_WRITE, MAP_SHARED, SANDBOX_FD, 0);
+    if (mem == MAP_FAILED)
+        return 1;
+    close(SANDBOX_FD);
+    auto *shared = static_cast<SandboxShared *>(mem);
+
+    RobotLibrary lib;
+    if (!open_robot_library(library_path, lib))
+    {
+        set_state(shared, HOST_FAILED);
+        return 1;
+    }
+
+    RobotBase *robot = lib.create();
+    Rng rng;
+    if (shared->has_rng && lib.attach_rng)
+    {
+        std::memcpy(static_cast<void *>(&rng), shared->rng, sizeof(Rng));
+        lib.attach_rng(robot, &rng);
+    }
+
+    shared->move = robot->get_move_speed();
+    shared->armor = robot->get_armor();
+    shared->weapon = robot->get_weapon();
+    std::strncpy(shared->name, robot->m_name.c_str(), sizeof(shared->name) - 1);
+    set_state(shared, HOST_READY);
+
+    auto forever = [] { return true; };
+    RobotCall call;
+    SandboxSlot slot;
+
+    while (shared->requests.pop(slot, forever))
+    {
+        SandboxRequest req = slot.request;
+        sync_robot(robot, req);
+
+        call.radar.resize(req.radar_count);
+        for (auto &obj : call.radar)
+        {
+            shared->requests.pop(slot, forever);
+            obj.m_type = static_cast<char>(slot.radar.type);
+            obj.m_row = slot.radar.row;
+            obj.m_col = slot.radar.col;
+        }
+
+        invoke(robot, static_cast<RobotCallback>(req.which), call);
+
+        slot.reply = {call.first, call.second, call.shoots};
+        shared->replies.push(slot, forever);
+    }
+    return 0;
+}
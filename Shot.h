@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include "Board.h"
+#include "OccupancyGrid.h"
+#include "RobotBase.h"
+
+// Shot footprints as the spec describes them.
+//
+// A shot travels from the shooter toward the cell it asked for, one cell
+// along the longer axis per step (from (2,2) at (4,5) that is (3,3), (3,4),
+// (4,5), (5,6)...). What it covers depends on the weapon:
+//
+//     railgun       the whole line, through everything, to the board edge
+//     flamethrower  the first 4 steps of the line, 3 cells wide
+//     hammer        the first step of the line
+//     grenade       the 3x3 block centred on the target cell
+//
+// Robots on the covered cells are found by reading the grid (cells of live
+// robots hold their index), so a shot costs the size of its footprint no
+// matter how many robots are in the match. A robot never hits itself.
+
+static const int FLAME_DEPTH = 4;
+
+// the line from (row, col) through (row + dr, col + dc)
+struct ShotLine
+{
+    int row, col;
+    int dr, dc;
+    int major;      // steps to reach the target; 0 if it is the shooter's cell
+
+    ShotLine(int from_row, int from_col, int to_row, int to_col)
+        : row(from_row), col(from_col), dr(to_row - from_row), dc(to_col - from_col),
+          major(std::max(std::abs(to_row - from_row), std::abs(to_col - from_col))) {}
+
+    // n / major, rounded half away from zero
+    long long scaled(long long n) const
+    {
+        return n >= 0 ? (2 * n + major) / (2 * major) : -((-2 * n + major) / (2 * major));
+    }
+
+    int row_at(int step) const { return row + static_cast<int>(scaled(static_cast<long long>(step) * dr)); }
+    int col_at(int step) const { return col + static_cast<int>(scaled(static_cast<long long>(step) * dc)); }
+
+    // a step walks the longer axis; the side cells lie across it
+    bool along_cols() const { return std::abs(dc) >= std::abs(dr); }
+};
+
+// first step after this one whose cell is in a different 64x64 tile. both
+// coordinates only ever move one way along a line, so a binary search over
+// the next tile's worth of steps finds it.
+inline int next_tile_step(const ShotLine &line, int step)
+{
+    const int shift = SparseGrid::TILE_SHIFT;
+    int tile_r = line.row_at(step) >> shift;
+    int tile_c = line.col_at(step) >> shift;
+
+    int lo = step + 1;
+    int hi = step + SparseGrid::TILE_SIZE;      // the long axis has left the tile by then
+    while (lo < hi)
+    {
+        int mid = lo + (hi - lo) / 2;
+        if ((line.row_at(mid) >> shift) != tile_r || (line.col_at(mid) >> shift) != tile_c)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return lo;
+}
+
+// appends the index of every robot other than shooter that the shot hits.
+// the footprint never covers a cell twice, so no robot appears twice. a
+// target off the board hits nothing.
+template <class Board, class Grid>
+void find_shot_targets(const Board &board, const Grid &grid, int shooter, WeaponType weapon,
+                       int row, int col, int shot_r, int shot_c, std::vector<int> &targets)
+{
+    if (!board.in_bounds(shot_r, shot_c))
+        return;
+
+    auto look = [&](int r, int c)
+    {
+        if (!board.in_bounds(r, c))
+            return;
+        uint8_t cell = cell_at(board, grid, r, c);
+        if (OccupancyGrid::is_robot(cell) && OccupancyGrid::robot_index(cell) != shooter)
+            targets.push_back(OccupancyGrid::robot_index(cell));
+    };
+
+    if (weapon == grenade)
+    {
+        for (int r = shot_r - 1; r <= shot_r + 1; r++)
+            for (int c = shot_c - 1; c <= shot_c + 1; c++)
+                look(r, c);
+        return;
+    }
+
+    ShotLine line(row, col, shot_r, shot_c);
+    if (line.major == 0)
+        return;
+
+    switch (weapon)
+    {
+        case railgun:
+            for (int step = 1; ; )
+            {
+                int r = line.row_at(step);
+                int c = line.col_at(step);
+                if (!board.in_bounds(r, c))
+                    break;
+                // long shots across a tiled board hop over empty tiles
+                if (in_empty_tile(grid, r, c))
+                {
+                    step = next_tile_step(line, step);
+                    continue;
+                }
+                look(r, c);
+                step++;
+            }
+            break;
+
+        case flamethrower:
+            for (int step = 1; step <= FLAME_DEPTH; step++)
+            {
+                int r = line.row_at(step);
+                int c = line.col_at(step);
+                look(r, c);
+                if (line.along_cols())
+                {
+                    look(r - 1, c);
+                    look(r + 1, c);
+                }
+                else
+                {
+                    look(r, c - 1);
+                    look(r, c + 1);
+                }
+            }
+            break;
+
+        case hammer:
+            look(line.row_at(1), line.col_at(1));
+            break;
+
+        default:
+            break;
+    }
+}
+
+// damage after armor: 10% less per point of armor the target has left
+inline int armor_reduced_damage(int damage, int armor)
+{
+    return damage - damage * armor / 10;
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "OccupancyGrid.h"
+
+// Arena occupancy for very large boards, stored as 64x64 tiles.
+//
+// Cells hold the same values as OccupancyGrid (CELL_EMPTY, obstacle
+// characters, CELL_ROBOT + index). A tile is allocated when something is
+// first put in it and freed again once it is empty, so memory follows what
+// is on the board rather than its size. One summary bit per tile says
+// whether it holds anything; the radar uses it to step over empty tiles
+// without looking at their cells.
+class SparseGrid
+{
+public:
+    static const int TILE_SHIFT = 6;
+    static const int TILE_SIZE = 1 << TILE_SHIFT;
+    static const int TILE_MASK = TILE_SIZE - 1;
+
+private:
+    struct Tile
+    {
+        uint8_t terrain[TILE_SIZE * TILE_SIZE] = {};
+        uint8_t cells[TILE_SIZE * TILE_SIZE] = {};
+        int used = 0;       // non-empty cells
+    };
+
+    int m_rows;
+    int m_cols;
+    int m_tile_rows;
+    int m_tile_cols;
+    int m_allocated = 0;
+
+    std::vector<std::unique_ptr<Tile>> m_tiles;    // row-major, null = empty
+    // bit t set <=> tile t has a non-empty cell
+    std::vector<uint64_t> m_summary;
+
+    int tile_of(int row, int col) const
+    {
+        return (row >> TILE_SHIFT) * m_tile_cols + (col >> TILE_SHIFT);
+    }
+
+    static int offset_in_tile(int row, int col)
+    {
+        return (row & TILE_MASK) * TILE_SIZE + (col & TILE_MASK);
+    }
+
+    Tile &tile_for_write(int tile)
+    {
+        if (!m_tiles[tile])
+        {
+            m_tiles[tile] = std::make_unique<Tile>();
+            m_summary[tile >> 6] |= uint64_t(1) << (tile & 63);
+            m_allocated++;
+        }
+        return *m_tiles[tile];
+    }
+
+    void set_cell(int row, int col, uint8_t cell)
+    {
+        int tile = tile_of(row, col);
+        if (cell == CELL_EMPTY && !m_tiles[tile])
+            return;
+
+        Tile &t = tile_for_write(tile);
+        uint8_t &slot = t.cells[offset_in_tile(row, col)];
+        t.used += (cell != CELL_EMPTY) - (slot != CELL_EMPTY);
+        slot = cell;
+
+        if (t.used == 0)
+        {
+            m_tiles[tile].reset();
+            m_summary[tile >> 6] &= ~(uint64_t(1) << (tile & 63));
+            m_allocated--;
+        }
+    }
+
+public:
+    SparseGrid(int rows, int cols)
+        : m_rows(rows), m_cols(cols),
+          m_tile_rows((rows + TILE_MASK) >> TILE_SHIFT),
+          m_tile_cols((cols + TILE_MASK) >> TILE_SHIFT),
+          m_tiles(static_cast<size_t>(m_tile_rows) * m_tile_cols),
+          m_summary((m_tiles.size() + 63) / 64, 0) {}
+
+    int rows() const { return m_rows; }
+    int cols() const { return m_cols; }
+
+    int tile_rows() const { return m_tile_rows; }
+    int tile_cols() const { return m_tile_cols; }
+    int allocated_tiles() const { return m_allocated; }
+
+    bool in_bounds(int row, int col) const
+    {
+        return row >= 0 && col >= 0 && row < m_rows && col < m_cols;
+    }
+
+    uint8_t at(int row, int col) const
+    {
+        const Tile *t = m_tiles[tile_of(row, col)].get();
+        return t ? t->cells[offset_in_tile(row, col)] : CELL_EMPTY;
+    }
+
+    // whether the tile holding (row, col) has anything in it
+    bool tile_occupied(int row, int col) const
+    {
+        int tile = tile_of(row, col);
+        return (m_summary[tile >> 6] >> (tile & 63)) & 1;
+    }
+
+    void place_obstacle(char type, int row, int col)
+    {
+        Tile &t = tile_for_write(tile_of(row, col));
+        t.terrain[offset_in_tile(row, col)] = static_cast<uint8_t>(type);
+        set_cell(row, col, static_cast<uint8_t>(type));
+    }
+
+    void place_robot(int index, int row, int col)
+    {
+        set_cell(row, col, static_cast<uint8_t>(CELL_ROBOT + index));
+    }
+
+    // lift a robot off its cell, uncovering whatever terrain was underneath.
+    // a robot's cell is never empty, so its tile is always there.
+    void remove_robot(int row, int col)
+    {
+        const Tile &t = *m_tiles[tile_of(row, col)];
+        set_cell(row, col, t.terrain[offset_in_tile(row, col)]);
+    }
+
+    void move_robot(int index, int from_row, int from_col, int to_row, int to_col)
+    {
+        // place first so a robot moving within a tile doesn't free it
+        place_robot(index, to_row, to_col);
+        remove_robot(from_row, from_col);
+    }
+
+    void kill_robot(int row, int col)
+    {
+        set_cell(row, col, 'X');
+    }
+};
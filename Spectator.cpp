@@ -0,0 +1,74 @@
+#include <algorithm>
+#include "Spectator.h"
+
+// how often the render thread looks for the frame it asked for
+static const auto FRAME_POLL = std::chrono::milliseconds(1);
+
+Spectator::Spectator(int rows, int cols, double fps)
+    : m_renderer(rows, cols, 0)
+{
+    if (fps > 0)
+        m_frame_time = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(1.0 / fps));
+
+    m_thread = std::thread(&Spectator::render_loop, this);
+}
+
+Spectator::~Spectator()
+{
+    finish();
+}
+
+void Spectator::publish(int round, const OccupancyGrid &grid, int count,
+                        const std::function<std::string(int)> &status)
+{
+    BoardSnapshot &frame = m_frames.back();
+    frame.round = round;
+    frame.grid = grid;
+    frame.status.resize(count);
+    for (int i = 0; i < count; i++)
+        frame.status[i] = status(i);
+
+    m_wanted.store(false, std::memory_order_relaxed);
+    m_frames.publish();
+}
+
+void Spectator::render_loop()
+{
+    auto next_frame = std::chrono::steady_clock::now();
+    while (true)
+    {
+        // the frame rate cap. finish() cuts it short so the last frame
+        // isn't held back.
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_wake.wait_until(lock, next_frame, [&] { return m_done.load(); });
+        }
+
+        m_wanted.store(true, std::memory_order_relaxed);
+        while (!m_frames.fresh() && !m_done.load())
+            std::this_thread::sleep_for(FRAME_POLL);
+
+        if (!m_frames.refresh())
+            return;   // done, and the last frame is already on screen
+
+        const BoardSnapshot &frame = m_frames.front();
+        m_renderer.draw(frame.round, frame.grid, frame.status);
+
+        next_frame = std::max(next_frame + m_frame_time, std::chrono::steady_clock::now());
+    }
+}
+
+void Spectator::finish()
+{
+    if (!m_thread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_done = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+    m_renderer.finish();
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "OccupancyGrid.h"
+#include "TerminalRenderer.h"
+#include "TripleBuffer.h"
+
+// the board as it stood at the start of a round, as the viewer draws it
+struct BoardSnapshot
+{
+    int round = 0;
+    OccupancyGrid grid{0, 0};
+    std::vector<std::string> status;   // one line per robot
+};
+
+// Watching a match (--render) from a thread of its own.
+//
+// The render thread asks for a frame whenever it is ready to draw one, at
+// most fps times a second, and the match copies the board into a
+// TripleBuffer at the start of the next round it plays. Neither side waits
+// for the other: a match that plays faster than the frame rate is only
+// copied as often as frames are drawn, and one that plays slower gets
+// every round drawn. The match's final board is always shown.
+class Spectator
+{
+private:
+    TripleBuffer<BoardSnapshot> m_frames;
+    std::atomic<bool> m_wanted{true};
+    std::atomic<bool> m_done{false};
+
+    TerminalRenderer m_renderer;   // the render thread's
+    std::chrono::steady_clock::duration m_frame_time{0};
+
+    std::mutex m_lock;
+    std::condition_variable m_wake;
+    std::thread m_thread;
+
+    void render_loop();
+
+public:
+    // starts the render thread. fps <= 0 draws as fast as the terminal
+    // takes frames.
+    Spectator(int rows, int cols, double fps);
+    ~Spectator();
+
+    Spectator(const Spectator &) = delete;
+    Spectator &operator=(const Spectator &) = delete;
+
+    // match thread: whether the render thread is waiting for a frame
+    bool wants_frame() const { return m_wanted.load(std::memory_order_relaxed); }
+
+    // match thread: copies the board for the render thread, with
+    // status(i) as robot i's line underneath it
+    void publish(int round, const OccupancyGrid &grid, int count, const std::function<std::string(int)> &status);
+
+    // draws the last board published, stops the render thread and leaves
+    // the cursor below the board
+    void finish();
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <thread>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// single-producer, single-consumer ring of fixed-size slots that can live in
+// memory shared between two processes.
+//
+// head and tail only ever count up; a slot's index is the count modulo
+// Capacity. the producer owns head and the consumer owns tail, so neither
+// side takes a lock. a side that finds nothing to do spins briefly and then
+// sleeps on a futex; the other side only makes the wake syscall when the
+// matching waiting flag says someone is asleep. the futexes are not
+// process-private, since the other side is another process.
+template <class Slot, uint32_t Capacity>
+class SpscRing
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "ring capacity must be a power of two");
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "futex words must be lock-free");
+
+private:
+    // on a single CPU the other side can't make progress while we spin
+    static int spins()
+    {
+        static const int count = std::thread::hardware_concurrency() > 1 ? 2000 : 0;
+        return count;
+    }
+
+    alignas(64) std::atomic<uint32_t> m_head{0};
+    std::atomic<uint32_t> m_consumer_waiting{0};
+    alignas(64) std::atomic<uint32_t> m_tail{0};
+    std::atomic<uint32_t> m_producer_waiting{0};
+    alignas(64) Slot m_slots[Capacity];
+
+    static void futex_wait(std::atomic<uint32_t> &word, uint32_t seen, long timeout_ns)
+    {
+        timespec timeout{0, timeout_ns};
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT, seen, &timeout, nullptr, 0);
+    }
+
+    static void futex_wake(std::atomic<uint32_t> &word)
+    {
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+    }
+
+    // waits until word moves off seen or alive() says to give up. the
+    // sleeps are short so that alive() is checked every few milliseconds.
+    template <class Alive>
+    static bool wait_for_change(std::atomic<uint32_t> &word, std::atomic<uint32_t> &waiting,
+                                uint32_t seen, Alive &&alive)
+    {
+        for (int spin = 0; spin < spins(); spin++)
+        {
+            if (word.load(std::memory_order_acquire) != seen)
+                return true;
+        }
+
+        while (true)
+        {
+            waiting.store(1);
+            if (word.load() == seen)
+                futex_wait(word, seen, 5 * 1000 * 1000);
+            waiting.store(0);
+
+            if (word.load(std::memory_order_acquire) != seen)
+                return true;
+            if (!alive())
+                return false;
+        }
+    }
+
+public:
+    // blocks while the ring is full. false if alive() gave up first.
+    template <class Alive>
+    bool push(const Slot &slot, Alive &&alive)
+    {
+        uint32_t head = m_head.load(std::memory_order_relaxed);
+        uint32_t tail = m_tail.load(std::memory_order_acquire);
+        while (head - tail == Capacity)
+        {
+            if (!wait_for_change(m_tail, m_producer_waiting, tail, alive))
+                return false;
+            tail = m_tail.load(std::memory_order_acquire);
+        }
+
+        m_slots[head % Capacity] = slot;
+        m_head.store(head + 1);
+        if (m_consumer_waiting.load())
+            futex_wake(m_head);
+        return true;
+    }
+
+    // blocks while the ring is empty. false if alive() gave up first.
+    template <class Alive>
+    bool pop(Slot &slot, Alive &&alive)
+    {
+        uint32_t tail = m_tail.load(std::memory_order_relaxed);
+        uint32_t head = m_head.load(std::memory_order_acquire);
+        while (head == tail)
+        {
+            if (!wait_for_change(m_head, m_consumer_waiting, head, alive))
+                return false;
+            head = m_head.load(std::memory_order_acquire);
+        }
+
+        slot = m_slots[tail % Capacity];
+        m_tail.store(tail + 1);
+        if (m_producer_waiting.load())
+            futex_wake(m_tail);
+        return true;
+    }
+};
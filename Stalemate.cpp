@@ -0,0 +1,117 @@
+#include <algorithm>
+#include "Stalemate.h"
+
+//
+// =========================================================
+//  ZOBRIST KEYS
+// =========================================================
+//
+
+uint64_t StalemateDetector::key(int robot, int feature, int value)
+{
+    // splitmix64 finaliser over the packed coordinates
+    uint64_t z = (static_cast<uint64_t>(robot) << 40) ^ (static_cast<uint64_t>(feature) << 32) ^
+                 static_cast<uint32_t>(value);
+    z += 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+//
+// =========================================================
+//  SEEN STATES
+// =========================================================
+//
+
+// the most the table is sized for. a match that goes longer without a hit
+// starts over when it fills, and still catches any loop shorter than that.
+static const size_t SEEN_MAX_SIZE = size_t(1) << 16;
+
+StalemateDetector::StalemateDetector(int repeat_limit, int robots, int rounds) : m_repeat_limit(repeat_limit)
+{
+    m_last.reserve(std::max(robots, 0));
+    if (!enabled())
+        return;
+
+    // kept at most half full, so probe runs stay short
+    size_t size = 2;
+    while (size < SEEN_MAX_SIZE && size < 2 * (static_cast<size_t>(std::max(rounds, 0)) + 1))
+        size *= 2;
+    m_seen.assign(size, SeenState{0, 0, 0});
+}
+
+int &StalemateDetector::seen(uint64_t hash)
+{
+    // only a match past the size cap gets here
+    if (2 * (m_seen_count + 1) > m_seen.size())
+        forget_seen();
+
+    size_t mask = m_seen.size() - 1;
+    for (size_t i = hash & mask; ; i = (i + 1) & mask)
+    {
+        SeenState &entry = m_seen[i];
+        if (entry.stamp != m_generation)
+        {
+            entry = {hash, m_generation, 0};
+            m_seen_count++;
+            return entry.count;
+        }
+        if (entry.hash == hash)
+            return entry.count;
+    }
+}
+
+void StalemateDetector::forget_seen()
+{
+    m_seen_count = 0;
+    if (++m_generation == 0)
+    {
+        // stamps wrapped round; old ones could look current again
+        std::fill(m_seen.begin(), m_seen.end(), SeenState{0, 0, 0});
+        m_generation = 1;
+    }
+}
+
+//
+// =========================================================
+//  ROUND UPDATES
+// =========================================================
+//
+
+void StalemateDetector::update(int robot, int row, int col, int health, int armor)
+{
+    if (robot == static_cast<int>(m_last.size()))
+    {
+        m_last.push_back({row, col, health, armor});
+        m_hash ^= position_key(robot, row, col) ^ key(robot, 2, health) ^ key(robot, 3, armor);
+        return;
+    }
+
+    RobotState &last = m_last[robot];
+
+    if (row != last.row || col != last.col)
+    {
+        m_hash ^= position_key(robot, last.row, last.col) ^ position_key(robot, row, col);
+        last.row = row;
+        last.col = col;
+    }
+
+    if (health != last.health || armor != last.armor)
+    {
+        m_hash ^= key(robot, 2, last.health) ^ key(robot, 2, health);
+        m_hash ^= key(robot, 3, last.armor) ^ key(robot, 3, armor);
+        last.health = health;
+        last.armor = armor;
+
+        // nothing seen before this can happen again
+        forget_seen();
+    }
+}
+
+bool StalemateDetector::end_round()
+{
+    if (!enabled())
+        return false;
+    return ++seen(m_hash) >= m_repeat_limit;
+}
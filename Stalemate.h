@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Spots matches that have stopped going anywhere.
+//
+// The arena state that matters for the outcome - where every robot is and
+// how much health and armor it has left - is kept as a Zobrist hash: one
+// pseudo-random key per (robot, feature, value), XORed together. Each round
+// only the features that changed are XORed out and back in.
+//
+// Health and armor only ever go down, so once either changes no earlier
+// state can come back. The table of seen states is dropped at that point
+// and only has to cover the stretch since the last hit. A state that comes
+// round repeat_limit times in that stretch is called a stalemate.
+//
+// A round adds at most one state, so the table is sized for the whole match
+// (up to a cap) before it starts and never allocates once it is running.
+class StalemateDetector
+{
+private:
+    struct RobotState
+    {
+        int row, col, health, armor;
+    };
+
+    // states seen since the last hit, open addressed. an entry counts only
+    // if its stamp is the current generation, so forgetting everything is
+    // a counter bump rather than a sweep, and the table's memory is kept.
+    struct SeenState
+    {
+        uint64_t hash;
+        uint32_t stamp;
+        int count;
+    };
+
+    int m_repeat_limit;
+    uint64_t m_hash = 0;
+    std::vector<RobotState> m_last;
+    std::vector<SeenState> m_seen;
+    uint32_t m_generation = 1;
+    size_t m_seen_count = 0;
+
+    int &seen(uint64_t hash);
+    void forget_seen();
+
+    // the key for one feature value. the keys are hashed from their
+    // coordinates rather than stored, so huge boards need no table.
+    static uint64_t key(int robot, int feature, int value);
+
+    static uint64_t position_key(int robot, int row, int col)
+    {
+        return key(robot, 0, row) ^ key(robot, 1, col);
+    }
+
+public:
+    // repeat_limit < 1 turns detection off. robots and rounds are how many
+    // the match will have, and size the tables.
+    StalemateDetector(int repeat_limit, int robots, int rounds);
+
+    bool enabled() const { return m_repeat_limit > 0; }
+    uint64_t hash() const { return m_hash; }
+
+    // robot i's state at the end of a round; i must count up from 0 on the
+    // first round
+    void update(int robot, int row, int col, int health, int armor);
+
+    // call after updating every robot for the round. true once the current
+    // state has been seen repeat_limit times since the last hit.
+    bool end_round();
+};
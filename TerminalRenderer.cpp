@@ -0,0 +1,156 @@
+#include <iostream>
+#include <thread>
+#include <unistd.h>
+#include "TerminalRenderer.h"
+
+// screen layout matches print_arena(): a banner line, a column label line,
+// then one line per row of "rr" followed by " c" per cell
+static const int BOARD_TOP = 3;     // screen line of arena row 0 (1-based)
+static const int BOARD_LEFT = 5;    // screen column of arena col 0 (1-based)
+
+TerminalRenderer::TerminalRenderer(int rows, int cols, double max_fps)
+    : m_rows(rows), m_cols(cols), m_on_screen(rows * cols, ' ')
+{
+    // worst case is the first frame: every cell plus labels and escapes
+    m_frame.reserve(static_cast<size_t>(rows) * (cols * 2 + 16) + cols * 4 + 1024);
+
+    if (max_fps > 0)
+        m_frame_time = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(1.0 / max_fps));
+}
+
+TerminalRenderer::~TerminalRenderer()
+{
+    finish();
+}
+
+void TerminalRenderer::append_number(int n)
+{
+    char digits[12];
+    int len = 0;
+    do
+    {
+        digits[len++] = static_cast<char>('0' + n % 10);
+        n /= 10;
+    } while (n > 0);
+
+    while (len > 0)
+        m_frame += digits[--len];
+}
+
+// ESC [ row ; col H
+void TerminalRenderer::append_cursor(int screen_row, int screen_col)
+{
+    m_frame += "\x1b[";
+    append_number(screen_row);
+    m_frame += ';';
+    append_number(screen_col);
+    m_frame += 'H';
+}
+
+void TerminalRenderer::flush_frame()
+{
+    const char *data = m_frame.data();
+    size_t left = m_frame.size();
+
+    while (left > 0)
+    {
+        ssize_t written = ::write(STDOUT_FILENO, data, left);
+        if (written <= 0)
+            break;
+        data += written;
+        left -= static_cast<size_t>(written);
+    }
+    m_frame.clear();
+}
+
+void TerminalRenderer::draw(int round, const OccupancyGrid &grid, const std::vector<std::string> &status)
+{
+    if (m_frame_time.count() > 0 && m_drawn)
+        std::this_thread::sleep_until(m_last_frame + m_frame_time);
+    m_last_frame = std::chrono::steady_clock::now();
+
+    if (!m_drawn)
+    {
+        // anything still sitting in cout would land in the middle of the board
+        std::cout.flush();
+
+        // clear, home, hide cursor, then the column labels (the banner is
+        // filled in below)
+        m_frame += "\x1b[2J\x1b[H\x1b[?25l\n   ";
+        for (int c = 0; c < m_cols; c++)
+        {
+            m_frame += c < 10 ? ' ' : static_cast<char>('0' + c / 10 % 10);
+            m_frame += static_cast<char>('0' + c % 10);
+        }
+
+        for (int r = 0; r < m_rows; r++)
+        {
+            m_frame += '\n';
+            m_frame += r < 10 ? ' ' : static_cast<char>('0' + r / 10 % 10);
+            m_frame += static_cast<char>('0' + r % 10);
+            m_frame += ' ';
+            for (int c = 0; c < m_cols; c++)
+            {
+                char glyph = OccupancyGrid::display_char(grid.at(r, c));
+                m_on_screen[r * m_cols + c] = glyph;
+                m_frame += ' ';
+                m_frame += glyph;
+            }
+        }
+        m_drawn = true;
+    }
+    else
+    {
+        for (int r = 0; r < m_rows; r++)
+        {
+            for (int c = 0; c < m_cols; c++)
+            {
+                char glyph = OccupancyGrid::display_char(grid.at(r, c));
+                char &shown = m_on_screen[r * m_cols + c];
+                if (glyph == shown)
+                    continue;
+
+                append_cursor(BOARD_TOP + r, BOARD_LEFT + 2 * c);
+                m_frame += glyph;
+                shown = glyph;
+            }
+        }
+    }
+
+    // the banner changes every frame; status lines only when a robot's stats do
+    append_cursor(1, 1);
+    m_frame += "=========== round ";
+    append_number(round);
+    m_frame += " ===========\x1b[K";
+
+    int count = static_cast<int>(status.size());
+    m_status.resize(count);
+    for (int i = 0; i < count; i++)
+    {
+        if (status[i] == m_status[i])
+            continue;
+
+        append_cursor(BOARD_TOP + m_rows + 1 + i, 1);
+        m_frame += OccupancyGrid::robot_glyph(i);
+        m_frame += ' ';
+        m_frame += status[i];
+        m_frame += "\x1b[K";
+        m_status[i] = status[i];
+    }
+
+    flush_frame();
+}
+
+void TerminalRenderer::finish()
+{
+    if (!m_drawn)
+        return;
+
+    // park the cursor under the status lines and show it again
+    append_cursor(BOARD_TOP + m_rows + 1 + static_cast<int>(m_status.size()), 1);
+    m_frame += "\x1b[?25h";
+    flush_frame();
+    m_drawn = false;
+    m_status.clear();
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include "OccupancyGrid.h"
+
+// Live board view for ANSI terminals.
+//
+// The first frame clears the screen and draws everything. After that only
+// the cells whose glyph changed are sent, each as a cursor move plus one
+// character, so a mostly static board costs a few bytes per round instead of
+// rows * cols. Each frame is built in one preallocated buffer and handed to
+// the terminal with a single write().
+class TerminalRenderer
+{
+private:
+    int m_rows;
+    int m_cols;
+
+    std::vector<char> m_on_screen;   // glyph currently shown in each cell
+    std::vector<std::string> m_status;   // status line currently shown per robot
+    std::string m_frame;             // reused every frame, never shrinks
+    bool m_drawn = false;
+
+    // 0 = no cap; otherwise draw() waits so frames are at least this far apart
+    std::chrono::steady_clock::duration m_frame_time{0};
+    std::chrono::steady_clock::time_point m_last_frame;
+
+    void append_number(int n);
+    void append_cursor(int screen_row, int screen_col);
+    void flush_frame();
+
+public:
+    // max_fps <= 0 draws as fast as the match runs
+    TerminalRenderer(int rows, int cols, double max_fps);
+    ~TerminalRenderer();
+
+    TerminalRenderer(const TerminalRenderer &) = delete;
+    TerminalRenderer &operator=(const TerminalRenderer &) = delete;
+
+    // draws the board plus the caller's status lines underneath it, one
+    // per robot
+    void draw(int round, const OccupancyGrid &grid, const std::vector<std::string> &status);
+
+    // leaves the cursor below the board and visible, ready for normal output
+    void finish();
+};
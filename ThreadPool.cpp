@@ -0,0 +1,64 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int threads)
+{
+    if (threads < 1)
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    if (threads < 1)
+        threads = 1;
+
+    for (int i = 0; i < threads; i++)
+        m_workers.emplace_back(&ThreadPool::worker_loop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_stopping = true;
+    }
+    m_task_ready.notify_all();
+
+    for (auto &worker : m_workers)
+        worker.join();
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_tasks.push_back(std::move(task));
+        m_unfinished++;
+    }
+    m_task_ready.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> guard(m_lock);
+    m_all_done.wait(guard, [this] { return m_unfinished == 0; });
+}
+
+void ThreadPool::worker_loop()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> guard(m_lock);
+            m_task_ready.wait(guard, [this] { return m_stopping || !m_tasks.empty(); });
+
+            if (m_tasks.empty())
+                return;
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+
+        task();
+
+        std::lock_guard<std::mutex> guard(m_lock);
+        if (--m_unfinished == 0)
+            m_all_done.notify_all();
+    }
+}
@@ -0,0 +1,228 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <filesystem>
+#include "Tournament.h"
+#include "Match.h"
+#include "RobotLoader.h"
+#include "RobotBuild.h"
+#include "WorkStealingPool.h"
+
+//
+// =========================================================
+//  ROBOT DISCOVERY
+// =========================================================
+//
+
+// every Robot_*.so in dir, sorted so the schedule is the same on every run
+static std::vector<std::string> find_robot_libraries(const std::string &dir)
+{
+    std::vector<std::string> paths;
+
+    std::error_code err;
+    for (const auto &entry : std::filesystem::directory_iterator(dir, err))
+    {
+        std::string name = entry.path().filename().string();
+        if (entry.is_regular_file() && name.rfind("Robot_", 0) == 0 &&
+            entry.path().extension() == ".so")
+            paths.push_back(entry.path().string());
+    }
+
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+// "./Robot_Toland.so" -> "Toland"
+static std::string robot_display_name(const std::string &path)
+{
+    std::string stem = std::filesystem::path(path).stem().string();
+    return stem.substr(std::string("Robot_").size());
+}
+
+//
+// =========================================================
+//  RATINGS
+// =========================================================
+//
+
+static const double ELO_START = 1500.0;
+static const double ELO_K = 16.0;
+
+// score is 1 for a win by a, 0.5 for a draw, 0 for a loss
+static void update_elo(double &a, double &b, double score)
+{
+    double expected = 1.0 / (1.0 + std::pow(10.0, (b - a) / 400.0));
+    a += ELO_K * (score - expected);
+    b -= ELO_K * (score - expected);
+}
+
+//
+// =========================================================
+//  TOURNAMENT
+// =========================================================
+//
+
+struct TournamentMatch
+{
+    int first;    // plays as A
+    int second;   // plays as B
+    MatchResult result;
+};
+
+int run_tournament(const std::string &dir, int seeds, int threads, uint64_t seed,
+                   const MatchOptions &match_opts)
+{
+    std::vector<RobotLibrary> libs;
+    std::vector<std::string> names;
+
+    // a robot that fails to compile just sits out, like one that fails to load
+    compile_robots(dir, threads);
+
+    for (const auto &path : find_robot_libraries(dir))
+    {
+        RobotLibrary lib;
+        if (!open_robot_library(path.c_str(), lib))
+            continue;
+        libs.push_back(lib);
+        names.push_back(robot_display_name(path));
+    }
+
+    int n = static_cast<int>(libs.size());
+    if (n < 2)
+    {
+        std::cerr << "ERROR: a tournament needs at least two Robot_*.so files in " << dir << "\n";
+        for (auto &lib : libs)
+            close_robot_library(lib);
+        return -1;
+    }
+
+    // every pairing x seeds. odd seeds swap sides so neither robot always
+    // gets to act first.
+    std::vector<TournamentMatch> schedule;
+    for (int i = 0; i < n; i++)
+        for (int j = i + 1; j < n; j++)
+            for (int k = 0; k < seeds; k++)
+            {
+                if (k % 2 == 0)
+                    schedule.push_back({i, j, {}});
+                else
+                    schedule.push_back({j, i, {}});
+            }
+
+    std::cout << "===== TOURNAMENT: " << n << " robots, "
+              << n * (n - 1) / 2 << " pairings x " << seeds << " seeds = "
+              << schedule.size() << " matches, seed " << seed << ", "
+              << match_opts.rows << "x" << match_opts.cols << " board =====\n";
+
+    WorkStealingPool pool(threads);
+    auto start = std::chrono::steady_clock::now();
+
+    pool.run(static_cast<int>(schedule.size()), [&](int task)
+    {
+        TournamentMatch &match = schedule[task];
+        match.result = play_match(libs[match.first], libs[match.second], seed + task, match_opts);
+    });
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    //
+    // ================= TALLY =================
+    //
+    // wins[i][j] = times i beat j; draws[i][j] is symmetric
+    std::vector<std::vector<int>> wins(n, std::vector<int>(n, 0));
+    std::vector<std::vector<int>> draws(n, std::vector<int>(n, 0));
+    std::vector<double> rating(n, ELO_START);
+    long long rounds = 0;
+    int stalemates = 0;
+
+    // ratings are folded in schedule order, not finish order, so they don't
+    // depend on thread timing
+    for (const auto &match : schedule)
+    {
+        int a = match.first;
+        int b = match.second;
+        rounds += match.result.rounds;
+        stalemates += match.result.stalemate;
+
+        if (match.result.winner < 0)
+        {
+            draws[a][b]++;
+            draws[b][a]++;
+            update_elo(rating[a], rating[b], 0.5);
+        }
+        else if (match.result.winner == 0)
+        {
+            wins[a][b]++;
+            update_elo(rating[a], rating[b], 1.0);
+        }
+        else
+        {
+            wins[b][a]++;
+            update_elo(rating[a], rating[b], 0.0);
+        }
+    }
+
+    //
+    // ================= W-L-D MATRIX =================
+    //
+    const int width = 12;
+    std::cout << "\nrow vs column, wins-losses-draws\n" << std::setw(width) << "";
+    for (int j = 0; j < n; j++)
+        std::cout << std::setw(width) << names[j].substr(0, width - 1);
+    std::cout << "\n";
+
+    for (int i = 0; i < n; i++)
+    {
+        std::cout << std::setw(width) << names[i].substr(0, width - 1);
+        for (int j = 0; j < n; j++)
+        {
+            std::string cell = "-";
+            if (i != j)
+                cell = std::to_string(wins[i][j]) + "-" + std::to_string(wins[j][i]) +
+                       "-" + std::to_string(draws[i][j]);
+            std::cout << std::setw(width) << cell;
+        }
+        std::cout << "\n";
+    }
+
+    //
+    // ================= RATING TABLE =================
+    //
+    std::vector<int> order(n);
+    for (int i = 0; i < n; i++)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return rating[a] > rating[b]; });
+
+    std::cout << "\n  # " << std::setw(width) << "robot" << std::setw(8) << "rating"
+              << std::setw(6) << "W" << std::setw(6) << "L" << std::setw(6) << "D" << "\n";
+
+    for (int place = 0; place < n; place++)
+    {
+        int i = order[place];
+        int w = 0, l = 0, d = 0;
+        for (int j = 0; j < n; j++)
+        {
+            w += wins[i][j];
+            l += wins[j][i];
+            d += draws[i][j];
+        }
+
+        std::cout << std::setw(3) << place + 1 << " " << std::setw(width) << names[i]
+                  << std::setw(8) << std::lround(rating[i])
+                  << std::setw(6) << w << std::setw(6) << l << std::setw(6) << d << "\n";
+    }
+
+    double secs = elapsed.count();
+    std::cout << "\n" << schedule.size() << " matches on " << pool.size() << " threads ("
+              << pool.steals() << " stolen) | " << stalemates << " stalemates | "
+              << schedule.size() / secs << " matches/sec | "
+              << rounds / secs << " rounds/sec\n";
+
+    for (auto &lib : libs)
+        close_robot_library(lib);
+    return 0;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "Match.h"
+
+// compiles the Robot_*.cpp files in dir (see RobotBuild.h), then plays
+// every pairing of the Robot_*.so files there, seeds times each
+// (alternating which robot acts first), spread over threads workers with
+// work stealing. match i of the schedule is seeded with seed + i. prints a
+// win/loss/draw matrix and a rating table. returns non-zero if fewer than
+// two robots could be loaded. match_opts gives the board and round limits
+// of every match.
+int run_tournament(const std::string &dir, int seeds, int threads, uint64_t seed,
+                   const MatchOptions &match_opts);
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// hands the latest value from one thread to another without either side
+// ever waiting for the other.
+//
+// there are three slots: the producer fills the back one, the consumer
+// reads the front one, and the third sits in the middle holding whatever
+// was published last. publishing swaps the back slot with the middle one;
+// refreshing swaps the middle one with the front. a single atomic byte
+// says which slot is in the middle and whether it is newer than the front,
+// so a publish the consumer never looked at is simply overwritten by the
+// next.
+template <class T>
+class TripleBuffer
+{
+private:
+    static const uint8_t INDEX = 0x3;
+    static const uint8_t FRESH = 0x4;   // the middle slot hasn't been read yet
+
+    struct alignas(64) Slot
+    {
+        T value;
+    };
+
+    Slot m_slots[3];
+    alignas(64) std::atomic<uint8_t> m_middle{2};
+    alignas(64) uint8_t m_back = 0;    // the producer's
+    alignas(64) uint8_t m_front = 1;   // the consumer's
+
+public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer &) = delete;
+    TripleBuffer &operator=(const TripleBuffer &) = delete;
+
+    // producer: the slot to fill before the next publish(). it still holds
+    // whatever was in it last, so buffers inside T can be reused.
+    T &back() { return m_slots[m_back].value; }
+
+    // producer: makes back() the latest value
+    void publish()
+    {
+        m_back = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel) & INDEX;
+    }
+
+    // consumer: whether a value newer than front() is waiting
+    bool fresh() const { return m_middle.load(std::memory_order_relaxed) & FRESH; }
+
+    // consumer: moves the latest value to front(). false, leaving front()
+    // as it was, if nothing was published since the last refresh.
+    bool refresh()
+    {
+        if (!fresh())
+            return false;
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    // consumer
+    const T &front() const { return m_slots[m_front].value; }
+};
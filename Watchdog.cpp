@@ -0,0 +1,176 @@
+#include "Watchdog.h"
+
+void invoke(RobotBase *robot, RobotCallback which, RobotCall &call)
+{
+    switch (which)
+    {
+        case CALL_RADAR_DIRECTION:
+            robot->get_radar_direction(call.first);
+            break;
+        case CALL_PROCESS_RADAR:
+            robot->process_radar_results(call.radar);
+            break;
+        case CALL_SHOT_LOCATION:
+            call.shoots = robot->get_shot_location(call.first, call.second);
+            break;
+        case CALL_MOVE_DIRECTION:
+            robot->get_move_direction(call.first, call.second);
+            break;
+        default:
+            break;
+    }
+}
+
+//
+// =========================================================
+//  ROBOT THREAD
+// =========================================================
+//
+
+void RobotGuard::thread_loop(std::shared_ptr<Shared> shared)
+{
+    std::unique_lock<std::mutex> hold(shared->lock);
+
+    while (true)
+    {
+        shared->posted.wait(hold, [&] { return shared->busy || shared->stopping; });
+        if (!shared->busy)
+            return;
+
+        // the call runs unlocked; the guard only reads the answer once busy
+        // is cleared
+        hold.unlock();
+        invoke(shared->robot, shared->which, shared->call);
+        hold.lock();
+
+        shared->busy = false;
+        if (shared->abandoned)
+        {
+            delete shared->robot;
+            shared->rng.reset();
+            return;
+        }
+        shared->answered.notify_one();
+    }
+}
+
+//
+// =========================================================
+//  GUARD
+// =========================================================
+//
+
+RobotGuard::RobotGuard(RobotBase *robot, std::shared_ptr<Rng> rng, std::chrono::nanoseconds budget,
+                       int max_overruns)
+    : m_shared(std::make_shared<Shared>()), m_budget(budget), m_max_overruns(max_overruns)
+{
+    m_shared->robot = robot;
+    m_shared->rng = std::move(rng);
+    m_thread = std::thread(&RobotGuard::thread_loop, m_shared);
+}
+
+RobotGuard::~RobotGuard()
+{
+    release();
+}
+
+bool RobotGuard::run(RobotCallback which, RobotCall &call)
+{
+    Shared &shared = *m_shared;
+    std::unique_lock<std::mutex> hold(shared.lock);
+
+    // still inside a call that overran: this one is forfeited too
+    if (shared.busy)
+    {
+        m_overruns++;
+        return false;
+    }
+
+    shared.which = which;
+    shared.call.first = call.first;
+    shared.call.second = call.second;
+    shared.call.shoots = call.shoots;
+    if (which == CALL_PROCESS_RADAR)
+        shared.call.radar = call.radar;
+    shared.busy = true;
+    shared.posted.notify_one();
+
+    if (!shared.answered.wait_for(hold, m_budget, [&] { return !shared.busy; }))
+    {
+        m_overruns++;
+        return false;
+    }
+
+    call.first = shared.call.first;
+    call.second = shared.call.second;
+    call.shoots = shared.call.shoots;
+    return true;
+}
+
+bool RobotGuard::busy() const
+{
+    std::lock_guard<std::mutex> hold(m_shared->lock);
+    return m_shared->busy;
+}
+
+bool RobotGuard::release()
+{
+    if (m_released)
+        return m_shared->abandoned;
+    m_released = true;
+
+    {
+        std::lock_guard<std::mutex> hold(m_shared->lock);
+        if (m_shared->busy)
+            m_shared->abandoned = true;
+        else
+            m_shared->stopping = true;
+        m_shared->posted.notify_one();
+    }
+
+    // a stuck thread can't be joined; it finishes on its own, if ever
+    if (m_shared->abandoned)
+        m_thread.detach();
+    else
+        m_thread.join();
+    return m_shared->abandoned;
+}
+
+//
+// =========================================================
+//  MATCH WATCHDOG
+// =========================================================
+//
+
+TurnWatchdog::TurnWatchdog(std::vector<RobotBase *> &robots, const std::vector<std::shared_ptr<Rng>> &rngs,
+                           double budget_ms, int max_overruns)
+    : m_robots(robots)
+{
+    if (budget_ms <= 0)
+        return;
+
+    auto budget = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<double, std::milli>(budget_ms));
+    for (size_t i = 0; i < robots.size(); i++)
+        m_guards.push_back(std::make_unique<RobotGuard>(robots[i], i < rngs.size() ? rngs[i] : nullptr,
+                                                        budget, max_overruns));
+}
+
+TurnWatchdog::~TurnWatchdog()
+{
+    for (size_t i = 0; i < m_guards.size(); i++)
+    {
+        if (m_guards[i]->release())
+            m_robots[i] = nullptr;
+    }
+}
+
+bool TurnWatchdog::run(int robot, RobotCallback which, RobotCall &call)
+{
+    if (!enabled())
+    {
+        invoke(m_robots[robot], which, call);
+        return true;
+    }
+    return m_guards[robot]->run(which, call);
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "RobotBase.h"
+#include "RadarObj.h"
+#include "Profiler.h"
+#include "Rng.h"
+
+// arguments and answers of one robot callback. which fields are used
+// depends on the call: first/second are the radar direction, the shot
+// target or the move direction and distance.
+struct RobotCall
+{
+    int first = 0;
+    int second = 0;
+    bool shoots = false;
+    std::vector<RadarObj> radar;   // in for process_radar_results
+};
+
+// makes the call on this thread
+void invoke(RobotBase *robot, RobotCallback which, RobotCall &call);
+
+// runs one robot's callbacks on a thread of its own, so the match can stop
+// waiting for a robot that takes too long.
+//
+// each call gets budget to answer. if it doesn't, the robot forfeits that
+// call and the match moves on while the robot's thread keeps running it.
+// until the call comes back every later one is forfeited as well. each
+// forfeit is an overrun; after max_overruns the robot is disqualified.
+//
+// the call's arguments and answers are copied into state the thread shares
+// with the guard, so a call that comes back late never writes into a match
+// that has moved on. a robot still stuck when the guard goes away is handed
+// to its thread, which deletes it if the call ever returns, along with the
+// random stream the robot draws from.
+class RobotGuard
+{
+private:
+    struct Shared
+    {
+        std::mutex lock;
+        std::condition_variable posted;
+        std::condition_variable answered;
+        RobotBase *robot;
+        std::shared_ptr<Rng> rng;   // the robot's stream; lives at least as long as the robot
+        RobotCallback which = CALL_RADAR_DIRECTION;
+        RobotCall call;
+        bool busy = false;        // a call is posted or running
+        bool stopping = false;
+        bool abandoned = false;   // the guard is gone; the thread owns the robot
+    };
+
+    std::shared_ptr<Shared> m_shared;
+    std::thread m_thread;
+    std::chrono::nanoseconds m_budget;
+    int m_max_overruns;
+    int m_overruns = 0;
+    bool m_released = false;
+
+    static void thread_loop(std::shared_ptr<Shared> shared);
+
+public:
+    RobotGuard(RobotBase *robot, std::shared_ptr<Rng> rng, std::chrono::nanoseconds budget, int max_overruns);
+    ~RobotGuard();
+
+    RobotGuard(const RobotGuard &) = delete;
+    RobotGuard &operator=(const RobotGuard &) = delete;
+
+    // false if the robot didn't answer within the budget; call is then
+    // left as it was
+    bool run(RobotCallback which, RobotCall &call);
+
+    int overruns() const { return m_overruns; }
+    bool disqualified() const { return m_max_overruns > 0 && m_overruns >= m_max_overruns; }
+
+    // whether the robot is still inside a call that overran. only run()
+    // starts calls, so once this is false the robot stays idle until the
+    // next run() and the match may touch it again.
+    bool busy() const;
+
+    // stops the thread. if the robot is still inside a call its thread takes
+    // it over instead and true is returned: the caller must not delete it.
+    // the destructor does this if it hasn't been done.
+    bool release();
+};
+
+// the guards for every robot in one match. with no budget there are none
+// and calls are made directly on the match thread.
+class TurnWatchdog
+{
+private:
+    std::vector<std::unique_ptr<RobotGuard>> m_guards;
+    std::vector<RobotBase *> &m_robots;
+
+public:
+    // budget_ms <= 0 turns the watchdog off; max_overruns < 1 never
+    // disqualifies. rngs, if not empty, holds each robot's random stream,
+    // which a robot left stuck in a call takes with it.
+    TurnWatchdog(std::vector<RobotBase *> &robots, const std::vector<std::shared_ptr<Rng>> &rngs,
+                 double budget_ms, int max_overruns);
+
+    // every robot still stuck in a call is handed to its thread, and its
+    // slot in robots is set to null so the caller won't delete it
+    ~TurnWatchdog();
+
+    bool enabled() const { return !m_guards.empty(); }
+
+    // false if the robot forfeits the call
+    bool run(int robot, RobotCallback which, RobotCall &call);
+
+    int overruns(int robot) const { return enabled() ? m_guards[robot]->overruns() : 0; }
+    bool disqualified(int robot) const { return enabled() && m_guards[robot]->disqualified(); }
+    bool busy(int robot) const { return enabled() && m_guards[robot]->busy(); }
+};
@@ -0,0 +1,71 @@
+#include <thread>
+#include "WorkStealingPool.h"
+
+WorkStealingPool::WorkStealingPool(int threads)
+{
+    if (threads < 1)
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    if (threads < 1)
+        threads = 1;
+
+    m_threads = threads;
+    for (int i = 0; i < threads; i++)
+        m_queues.push_back(std::make_unique<TaskQueue>());
+}
+
+bool WorkStealingPool::pop_own(int worker, int &task)
+{
+    TaskQueue &queue = *m_queues[worker];
+    std::lock_guard<std::mutex> guard(queue.lock);
+    if (queue.tasks.empty())
+        return false;
+
+    task = queue.tasks.back();
+    queue.tasks.pop_back();
+    return true;
+}
+
+// victims are tried in order starting after the thief, so thieves spread
+// out instead of all hammering worker 0
+bool WorkStealingPool::steal(int thief, int &task)
+{
+    for (int i = 1; i < m_threads; i++)
+    {
+        TaskQueue &queue = *m_queues[(thief + i) % m_threads];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        if (queue.tasks.empty())
+            continue;
+
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+        m_steals++;
+        return true;
+    }
+    return false;
+}
+
+// no task ever creates another, so once every deque is empty the worker
+// can't find more work later and is done
+void WorkStealingPool::worker_loop(int worker, const std::function<void(int)> &job)
+{
+    int task;
+    while (pop_own(worker, task) || steal(worker, task))
+        job(task);
+}
+
+void WorkStealingPool::run(int count, const std::function<void(int)> &job)
+{
+    // deal contiguous blocks so each worker starts on its own slice
+    for (int i = 0; i < count; i++)
+    {
+        int owner = static_cast<int>(static_cast<long long>(i) * m_threads / count);
+        m_queues[owner]->tasks.push_back(i);
+    }
+
+    std::vector<std::thread> workers;
+    for (int w = 0; w < m_threads; w++)
+        workers.emplace_back(&WorkStealingPool::worker_loop, this, w, std::cref(job));
+
+    for (auto &worker : workers)
+        worker.join();
+}
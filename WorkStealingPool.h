@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// runs a fixed batch of independent tasks with one deque per worker.
+//
+// tasks are dealt out to the workers up front. a worker takes from the back
+// of its own deque and, once that is empty, steals from the front of someone
+// else's. long tasks then hold up only the worker running them instead of
+// the whole static share queued behind them.
+class WorkStealingPool
+{
+private:
+    struct TaskQueue
+    {
+        std::mutex lock;
+        std::deque<int> tasks;
+    };
+
+    int m_threads;
+    std::vector<std::unique_ptr<TaskQueue>> m_queues;
+    std::atomic<long long> m_steals{0};
+
+    bool pop_own(int worker, int &task);
+    bool steal(int thief, int &task);
+    void worker_loop(int worker, const std::function<void(int)> &job);
+
+public:
+    // threads < 1 means one per hardware thread
+    explicit WorkStealingPool(int threads);
+
+    int size() const { return m_threads; }
+
+    // how many tasks were run by a worker other than the one they were dealt to
+    long long steals() const { return m_steals.load(); }
+
+    // calls job(i) for every i in [0, count) and returns once all are done
+    void run(int count, const std::function<void(int)> &job);
+};
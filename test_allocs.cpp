@@ -0,0 +1,217 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+#include "Match.h"
+#include "Rng.h"
+
+//
+// =========================================================
+//  test_allocs - a running match must not touch the heap
+// =========================================================
+//
+// every operator new in the process is counted. a few robots that never
+// allocate themselves play whole matches on each of the board shapes the
+// match core is specialized for, and each of them looks at the count once
+// a turn: anything between two of its turns was allocated by a round. the
+// setup before round 1 may allocate as much as it likes.
+//
+
+static std::atomic<long long> g_allocations{0};
+
+static void *counted_alloc(std::size_t size, std::size_t align)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0)
+        size = 1;
+    void *p = align > alignof(std::max_align_t) ? std::aligned_alloc(align, (size + align - 1) / align * align)
+                                                : std::malloc(size);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void *operator new(std::size_t size) { return counted_alloc(size, 0); }
+void *operator new[](std::size_t size) { return counted_alloc(size, 0); }
+void *operator new(std::size_t size, std::align_val_t align) { return counted_alloc(size, static_cast<std::size_t>(align)); }
+void *operator new[](std::size_t size, std::align_val_t align) { return counted_alloc(size, static_cast<std::size_t>(align)); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+// what the robots saw across every match on one board
+struct AllocReport
+{
+    long long turns = 0;
+    long long allocating_turns = 0;
+    long long allocations = 0;
+};
+
+//
+// =========================================================
+//  ROBOT
+// =========================================================
+//
+// scans at random, shoots at the first robot its radar finds and wanders
+// a step at a time, so radar, every weapon, hits, deaths and the stalemate
+// table all get a workout. it keeps nothing that needs the heap.
+//
+
+class Wanderer : public RobotBase
+{
+private:
+    Rng m_rng;
+    AllocReport &m_report;
+    long long m_seen = -1;
+    bool m_target = false;
+    int m_target_row = 0, m_target_col = 0;
+
+public:
+    Wanderer(WeaponType weapon, uint64_t seed, AllocReport &report)
+        : RobotBase(2, 3, weapon), m_rng(seed), m_report(report)
+    {
+    }
+
+    void get_radar_direction(int &radar_direction) override
+    {
+        long long now = g_allocations.load(std::memory_order_relaxed);
+        if (m_seen >= 0)
+        {
+            m_report.turns++;
+            if (now != m_seen)
+            {
+                m_report.allocating_turns++;
+                m_report.allocations += now - m_seen;
+            }
+        }
+        m_seen = now;
+
+        radar_direction = m_rng.range(0, 8);
+    }
+
+    void process_radar_results(const std::vector<RadarObj> &radar_results) override
+    {
+        m_target = false;
+        for (const auto &obj : radar_results)
+        {
+            if (obj.m_type == 'R')
+            {
+                m_target = true;
+                m_target_row = obj.m_row;
+                m_target_col = obj.m_col;
+                return;
+            }
+        }
+    }
+
+    bool get_shot_location(int &shot_row, int &shot_col) override
+    {
+        shot_row = m_target_row;
+        shot_col = m_target_col;
+        return m_target;
+    }
+
+    void get_move_direction(int &direction, int &distance) override
+    {
+        direction = m_rng.range(1, 8);
+        distance = 1;
+    }
+};
+
+//
+// =========================================================
+//  MATCHES
+// =========================================================
+//
+
+static const WeaponType WEAPONS[] = {flamethrower, railgun, grenade, hammer};
+
+static AllocReport play_board(int rows, int cols, int matches, int max_rounds, uint64_t seed)
+{
+    AllocReport report;
+
+    MatchOptions opts;
+    opts.rows = rows;
+    opts.cols = cols;
+    opts.max_rounds = max_rounds;
+
+    for (int m = 0; m < matches; m++)
+    {
+        Rng rng(seed + m);
+        std::vector<RobotBase *> robots;
+        for (int i = 0; i < 4; i++)
+        {
+            robots.push_back(new Wanderer(WEAPONS[i], rng.next(), report));
+            robots.back()->m_name = "Wanderer " + std::to_string(i);
+        }
+
+        run_match(robots, rng, opts);
+
+        for (auto *robot : robots)
+            delete robot;
+    }
+    return report;
+}
+
+void print_usage(const char *program)
+{
+    std::cout << "Usage: " << program << " [--matches N] [--rounds N] [--seed S]\n"
+              << "       plays N matches of up to --rounds rounds on each board and fails if\n"
+              << "       any round allocates\n";
+}
+
+int main(int argc, char *argv[])
+{
+    int matches = 20;
+    int max_rounds = 3000;
+    uint64_t seed = 1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--matches") == 0 && i + 1 < argc)
+            matches = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--rounds") == 0 && i + 1 < argc)
+            max_rounds = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        else
+        {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (matches < 1 || max_rounds < 1)
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    // the three specialized cores and the generic one
+    static const int BOARDS[][2] = {{10, 10}, {20, 20}, {64, 64}, {100, 100}};
+
+    int rc = 0;
+    for (const auto &board : BOARDS)
+    {
+        AllocReport report = play_board(board[0], board[1], matches, max_rounds, seed);
+        std::cout << board[0] << "x" << board[1] << ": " << report.turns << " turns, ";
+        if (report.allocating_turns == 0)
+            std::cout << "no allocations\n";
+        else
+        {
+            std::cout << report.allocations << " allocations in " << report.allocating_turns << " turns\n";
+            rc = 1;
+        }
+    }
+
+    std::cout << (rc == 0 ? "PASS" : "FAIL") << ": rounds allocate " << (rc == 0 ? "nothing" : "on the heap") << "\n";
+    return rc;
+}
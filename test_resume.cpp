@@ -0,0 +1,175 @@
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "Match.h"
+#include "RobotLoader.h"
+#include "Rng.h"
+
+//
+// =========================================================
+//  test_resume - a paused match plays on as if it never stopped
+// =========================================================
+//
+// every seed is played straight through, then played again up to a few
+// rounds before its end, paused, and resumed with the same robots and a
+// copy of the paused arena stream. resume_match promises both end the
+// same way, stalemates included, so any difference in the winner, the
+// round it ended on or how it ended is a failure.
+//
+
+// fresh robots with streams split off rng, the way play_match and the
+// rollouts do it. rngs must not be resized once the robots hold them.
+static void create_robots(const std::vector<RobotLibrary> &libs, Rng &rng, std::vector<Rng> &rngs,
+                          std::vector<RobotBase *> &robots)
+{
+    for (size_t i = 0; i < libs.size(); i++)
+        rngs.push_back(rng.split());
+
+    for (size_t i = 0; i < libs.size(); i++)
+    {
+        robots.push_back(libs[i].create());
+        if (libs[i].attach_rng)
+            libs[i].attach_rng(robots[i], &rngs[i]);
+    }
+}
+
+static void delete_robots(std::vector<RobotBase *> &robots)
+{
+    for (auto *robot : robots)
+        delete robot;
+    robots.clear();
+}
+
+static bool same_result(const MatchResult &a, const MatchResult &b)
+{
+    return a.winner == b.winner && a.rounds == b.rounds && a.stalemate == b.stalemate;
+}
+
+static void print_result(const MatchResult &result)
+{
+    if (result.stalemate)
+        std::cout << "stalemate";
+    else if (result.winner < 0)
+        std::cout << "draw";
+    else
+        std::cout << "robot " << result.winner << " wins";
+    std::cout << " after " << result.rounds << " rounds";
+}
+
+// plays seed straight through and resumed from back rounds before the
+// end. false, with the two results printed, if they differ.
+static bool check_seed(const std::vector<RobotLibrary> &libs, uint64_t seed, int back, MatchResult &straight)
+{
+    MatchOptions opts;
+    opts.seed = seed;
+
+    {
+        Rng rng(seed);
+        std::vector<Rng> rngs;
+        std::vector<RobotBase *> robots;
+        create_robots(libs, rng, rngs, robots);
+        straight = run_match(robots, rng, opts);
+        delete_robots(robots);
+    }
+
+    if (straight.rounds <= back)
+        return true;   // nothing to pause before
+
+    Rng rng(seed);
+    std::vector<Rng> rngs;
+    std::vector<RobotBase *> robots;
+    create_robots(libs, rng, rngs, robots);
+
+    ArenaState state;
+    MatchOptions pausing = opts;
+    pausing.pause_round = straight.rounds - back;
+    pausing.paused = &state;
+    MatchResult paused = run_match(robots, rng, pausing);
+
+    MatchResult resumed = paused;
+    if (paused.winner == MATCH_PAUSED)
+    {
+        Rng carry_on = state.rng;
+        resumed = resume_match(state, robots, carry_on, opts);
+    }
+    delete_robots(robots);
+
+    if (same_result(straight, resumed))
+        return true;
+
+    std::cout << "seed " << seed << ": ";
+    print_result(straight);
+    std::cout << " straight through, but ";
+    print_result(resumed);
+    std::cout << " resumed from round " << pausing.pause_round << "\n";
+    return false;
+}
+
+void print_usage(const char *program)
+{
+    std::cout << "Usage: " << program << " [--seeds N] [--back R] robot1.so robot2.so ...\n"
+              << "       plays seeds 1..N straight through and paused R rounds before the\n"
+              << "       end, and fails if any resumed match ends differently\n";
+}
+
+int main(int argc, char *argv[])
+{
+    int seeds = 50;
+    int back = 8;
+    std::vector<const char *> paths;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--seeds") == 0 && i + 1 < argc)
+            seeds = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--back") == 0 && i + 1 < argc)
+            back = std::atoi(argv[++i]);
+        else if (argv[i][0] != '-')
+            paths.push_back(argv[i]);
+        else
+        {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (seeds < 1 || back < 1 || paths.size() < 2)
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<RobotLibrary> libs(paths.size());
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        if (!open_robot_library(paths[i], libs[i]))
+            return 1;
+    }
+
+    int failed = 0, stalemates = 0;
+    for (int seed = 1; seed <= seeds; seed++)
+    {
+        MatchResult straight;
+        if (!check_seed(libs, static_cast<uint64_t>(seed), back, straight))
+            failed++;
+        stalemates += straight.stalemate;
+    }
+
+    for (auto &lib : libs)
+        close_robot_library(lib);
+
+    std::cout << seeds << " seeds resumed " << back << " rounds before the end, " << stalemates
+              << " of them stalemates: ";
+    if (failed > 0)
+    {
+        std::cout << "FAIL, " << failed << " ended differently\n";
+        return 1;
+    }
+    if (stalemates == 0)
+    {
+        std::cout << "FAIL, no stalemate to check; try more --seeds\n";
+        return 1;
+    }
+    std::cout << "PASS\n";
+    return 0;
+}
@@ -1,8 +1,17 @@
 #include "RobotBase.h"
+#include "Rng.h"
 #include <iostream>
+#include <iomanip>
 #include <vector>
 #include <dlfcn.h>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
 
 RobotBase* load_robot(const std::string& shared_lib, void* &handle) 
 {
@@ -141,18 +150,292 @@ void test_robot_behavior(RobotBase* robot)
 
 
 
-int main(int argc, char* argv[]) 
+//
+// =========================================================
+//  STRESS MODE
+// =========================================================
+//
+// many robots at once, one per worker thread at a time, fed random boards,
+// positions and radar results as fast as they will take them. every answer
+// is checked against what the arena accepts, and calls slower than the
+// limit are counted. a robot that crashes takes the tester down with it;
+// the arena's --sandbox is the place to find those.
+//
+
+// optional robot export that hands the robot its own random stream (see Rng.h)
+typedef void (*RngHook)(RobotBase*, Rng*);
+
+struct StressOptions
+{
+    int threads = 0;                    // < 1 = one per hardware thread
+    long long turns = 1000000;          // across all threads
+    uint64_t seed = 1;
+    double slow_us = 1000;              // a call at least this long counts as slow
+};
+
+enum StressProblem { BAD_RADAR, BAD_SHOT, BAD_DIRECTION, BAD_DISTANCE, THREW, SLOW_CALL, PROBLEM_COUNT };
+
+static const char* const PROBLEM_NAMES[PROBLEM_COUNT] =
+{
+    "radar direction outside 0-8",
+    "shot off the board",
+    "move direction outside 0-8",
+    "move distance outside 0-speed",
+    "threw an exception",
+    "slow call"
+};
+
+// what every worker reports into
+struct StressReport
+{
+    std::atomic<long long> turns{0};
+    std::atomic<long long> robots{0};
+    std::atomic<long long> counts[PROBLEM_COUNT] = {};
+    std::atomic<long long> slowest_ns{0};
+
+    std::mutex lock;
+    std::string examples[PROBLEM_COUNT];   // the first of each, to reproduce by hand
+
+    void flag(StressProblem problem, const std::string& detail)
+    {
+        if (counts[problem]++ == 0)
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            examples[problem] = detail;
+        }
+    }
+
+    void timed(long long ns, double slow_us, const char* call, int rows, int cols)
+    {
+        long long seen = slowest_ns.load();
+        while (ns > seen && !slowest_ns.compare_exchange_weak(seen, ns))
+        {
+        }
+        if (ns >= slow_us * 1000)
+            flag(SLOW_CALL, std::string(call) + " took " + std::to_string(ns / 1000) + "us on a " +
+                            std::to_string(rows) + "x" + std::to_string(cols) + " board");
+    }
+};
+
+// a board size: mostly the usual sort, sometimes tiny or long and thin
+static void random_board(Rng& rng, int& rows, int& cols)
+{
+    switch (rng.below(8))
+    {
+        case 0:  rows = rng.range(1, 4);  cols = rng.range(1, 4);   break;
+        case 1:  rows = rng.range(1, 3);  cols = rng.range(50, 200); break;
+        case 2:  rows = rng.range(50, 200); cols = rng.range(1, 3);  break;
+        case 3:  rows = rng.range(60, 200); cols = rng.range(60, 200); break;
+        default: rows = rng.range(10, 40); cols = rng.range(10, 40); break;
+    }
+}
+
+// what a radar might report: a few cells anywhere on the board, live robots
+// and wrecks included. real scans only cover one direction; robots should
+// cope with anything on the board.
+static void random_radar(Rng& rng, int rows, int cols, int row, int col, std::vector<RadarObj>& results)
+{
+    static const char types[] = {'R', 'R', 'M', 'P', 'F', 'X'};
+
+    results.clear();
+    int count = rng.below(4) == 0 ? 0 : rng.range(1, 12);
+    for (int i = 0; i < count; i++)
+    {
+        int r = rng.below(rows), c = rng.below(cols);
+        if (r == row && c == col)
+            continue;
+        results.emplace_back(types[rng.below(sizeof(types))], r, c);
+    }
+}
+
+static std::string where(int rows, int cols, int row, int col)
+{
+    return "at (" + std::to_string(row) + ", " + std::to_string(col) + ") on a " +
+           std::to_string(rows) + "x" + std::to_string(cols) + " board";
+}
+
+// times call() and reports it; returns false if the robot threw
+template <typename Call>
+static bool stress_call(StressReport& report, const StressOptions& opts, const char* name,
+                        int rows, int cols, int row, int col, Call call)
+{
+    auto start = std::chrono::steady_clock::now();
+    try
+    {
+        call();
+    }
+    catch (const std::exception& e)
+    {
+        report.flag(THREW, std::string(name) + " threw \"" + e.what() + "\" " + where(rows, cols, row, col));
+        return false;
+    }
+    catch (...)
+    {
+        report.flag(THREW, std::string(name) + " threw " + where(rows, cols, row, col));
+        return false;
+    }
+    long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    report.timed(ns, opts.slow_us, name, rows, cols);
+    return true;
+}
+
+// one robot for its whole life: one board, up to turns turns. returns how
+// many it played before it finished or threw.
+static long long stress_robot(RobotFactory create, RngHook attach_rng, Rng& rng, long long turns,
+                              const StressOptions& opts, StressReport& report)
 {
-    //argv[1] should contain the name of the Robot_.cpp file to load.
+    int rows, cols;
+    random_board(rng, rows, cols);
+    int row = rng.below(rows), col = rng.below(cols);
+
+    RobotBase* robot = create();
+    Rng robot_rng = rng.split();
+    if (attach_rng)
+        attach_rng(robot, &robot_rng);
+    robot->set_boundaries(rows, cols);
+    robot->move_to(row, col);
+    report.robots++;
+
+    std::vector<RadarObj> radar;
+    long long done = 0;
+
+    for (; done < turns; done++)
+    {
+        // now and then the arena moves the robot somewhere it didn't ask for
+        if (rng.below(16) == 0)
+        {
+            row = rng.below(rows);
+            col = rng.below(cols);
+            robot->move_to(row, col);
+        }
+
+        int radar_direction = -1;
+        if (!stress_call(report, opts, "get_radar_direction", rows, cols, row, col,
+                         [&] { robot->get_radar_direction(radar_direction); }))
+            break;
+        if (radar_direction < 0 || radar_direction > 8)
+            report.flag(BAD_RADAR, "direction " + std::to_string(radar_direction) + " " + where(rows, cols, row, col));
+
+        random_radar(rng, rows, cols, row, col, radar);
+        if (!stress_call(report, opts, "process_radar_results", rows, cols, row, col,
+                         [&] { robot->process_radar_results(radar); }))
+            break;
 
-    if (argc != 2) 
+        int shot_row = 0, shot_col = 0;
+        bool shoots = false;
+        if (!stress_call(report, opts, "get_shot_location", rows, cols, row, col,
+                         [&] { shoots = robot->get_shot_location(shot_row, shot_col); }))
+            break;
+        if (shoots && (shot_row < 0 || shot_col < 0 || shot_row >= rows || shot_col >= cols))
+            report.flag(BAD_SHOT, "shot at (" + std::to_string(shot_row) + ", " + std::to_string(shot_col) + ") " +
+                                  where(rows, cols, row, col));
+
+        int move_direction = -1, move_distance = -1;
+        if (!stress_call(report, opts, "get_move_direction", rows, cols, row, col,
+                         [&] { robot->get_move_direction(move_direction, move_distance); }))
+            break;
+
+        if (move_direction < 0 || move_direction > 8)
+        {
+            report.flag(BAD_DIRECTION, "direction " + std::to_string(move_direction) + " " + where(rows, cols, row, col));
+            continue;
+        }
+        if (move_distance < 0 || move_distance > robot->get_move_speed())
+            report.flag(BAD_DISTANCE, "distance " + std::to_string(move_distance) + " at speed " +
+                                      std::to_string(robot->get_move_speed()) + " " + where(rows, cols, row, col));
+
+        // move the way the arena would, stopping at the edge
+        int steps = std::clamp(move_distance, 0, robot->get_move_speed());
+        for (int step = 0; step < steps && move_direction != 0; step++)
+        {
+            int r = row + directions[move_direction].first;
+            int c = col + directions[move_direction].second;
+            if (r < 0 || c < 0 || r >= rows || c >= cols)
+                break;
+            row = r;
+            col = c;
+        }
+        robot->move_to(row, col);
+    }
+
+    delete robot;
+    return done;
+}
+
+int run_stress(void* handle, const StressOptions& opts)
+{
+    RobotFactory create = (RobotFactory)dlsym(handle, "create_robot");
+    RngHook attach_rng = (RngHook)dlsym(handle, "attach_rng");
+    if (!create)
     {
-        std::cerr << "Usage: " << argv[0] << " <robot_library>\n";
+        std::cerr << "Failed to find create_robot: " << dlerror() << '\n';
         return 1;
     }
 
-    const std::string robot_file = argv[1];
-    const std::string shared_lib = "lib" + robot_file.substr(0, robot_file.find(".cpp")) + ".so";
+    int threads = opts.threads > 0 ? opts.threads : std::max(1u, std::thread::hardware_concurrency());
+    StressReport report;
+    std::atomic<long long> remaining{opts.turns};
+
+    std::cout << "Stressing with " << threads << " threads, " << opts.turns << " turns, seed " << opts.seed << "...\n";
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&, t]
+        {
+            Rng rng(opts.seed * 0x9e3779b97f4a7c15ULL + t);
+            while (true)
+            {
+                // claim the next robot's lifetime out of what is left
+                long long life = rng.range(1, 200);
+                long long left = remaining.load();
+                while (left > 0 && !remaining.compare_exchange_weak(left, left - std::min(life, left)))
+                {
+                }
+                if (left <= 0)
+                    break;
+                report.turns += stress_robot(create, attach_rng, rng, std::min(life, left), opts, report);
+            }
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    long long turns = report.turns.load();
+
+    std::cout << std::fixed << std::setprecision(0)
+              << turns << " turns (" << 4 * turns << " calls) by " << report.robots.load() << " robots in "
+              << std::setprecision(2) << secs << "s: " << std::setprecision(0)
+              << turns / secs << " decisions/sec, " << 4 * turns / secs << " calls/sec, slowest call "
+              << std::setprecision(1) << report.slowest_ns.load() / 1000.0 << "us\n" << std::defaultfloat;
+
+    // slow calls are worth knowing about but aren't wrong answers
+    int failed = 0;
+    for (int p = 0; p < PROBLEM_COUNT; p++)
+    {
+        long long count = report.counts[p].load();
+        if (count == 0)
+            continue;
+        std::cerr << (p == SLOW_CALL ? "Warning: " : "Error: ") << PROBLEM_NAMES[p] << ": " << count
+                  << " (first: " << report.examples[p] << ")\n";
+        if (p != SLOW_CALL)
+            failed++;
+    }
+    if (failed == 0)
+        std::cout << "No invalid outputs.\n";
+    return failed ? 1 : 0;
+}
+
+// compiles robot_file the way the arena does if it is a .cpp; a .so is used as is
+std::string build_robot(const std::string& robot_file)
+{
+    if (robot_file.size() > 3 && robot_file.compare(robot_file.size() - 3, 3, ".so") == 0)
+        return robot_file;
+
+    // dlopen only looks in the current directory for a path with a slash in it
+    const std::string shared_lib = "./lib" + robot_file.substr(0, robot_file.find(".cpp")) + ".so";
 
     // Compile the robot into a shared library -fPIC is Position Independant Code - look it up!
     // we're also linking a pre-compiled RobotBase.o - problems will arise if there is a mismatch...
@@ -161,16 +444,69 @@ int main(int argc, char* argv[])
 
     if (std::system(compile_cmd.c_str()) != 0) {
         std::cerr << "Failed to compile " << robot_file << " into " << shared_lib << '\n';
-        return 1;
+        return "";
     }
 
     std::cout << "Success!" << std::endl;
+    return shared_lib;
+}
+
+void print_usage(const char* program)
+{
+    std::cerr << "Usage: " << program << " <robot_library>\n"
+              << "       " << program << " --stress [--threads T] [--turns N] [--seed S] [--slow-us US] <robot_library>\n"
+              << "robot_library is a Robot_*.cpp (compiled first) or a built .so\n";
+}
+
+int main(int argc, char* argv[]) 
+{
+    //the last argument should contain the name of the Robot_.cpp file to load.
+
+    bool stress = false;
+    bool bad_args = false;
+    StressOptions opts;
+    std::string robot_file;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--stress") == 0)
+            stress = true;
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            opts.threads = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--turns") == 0 && i + 1 < argc)
+            opts.turns = std::atoll(argv[++i]);
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            opts.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--slow-us") == 0 && i + 1 < argc)
+            opts.slow_us = std::atof(argv[++i]);
+        else if (argv[i][0] != '-' && robot_file.empty())
+            robot_file = argv[i];
+        else
+            bad_args = true;
+    }
+
+    if (bad_args || robot_file.empty() || (!stress && argc != 2) || opts.turns < 1)
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    const std::string shared_lib = build_robot(robot_file);
+    if (shared_lib.empty())
+        return 1;
 
     RobotBase *robot;
     void *handle;
 
     robot = load_robot(shared_lib, handle);
-    test_robot_behavior(robot);
+    if (!robot)
+        return 1;
+
+    int rc = 0;
+    if (stress)
+        rc = run_stress(handle, opts);
+    else
+        test_robot_behavior(robot);
 
     // Cleanup
     delete robot;
@@ -178,5 +514,5 @@ int main(int argc, char* argv[])
 
     std::cout << "Robot testing complete.\n";
 
-    return 0;
+    return rc;
 }